@@ -1,10 +1,15 @@
 #pragma once
 
+#include <cassert>
+#include <cstdint>
 #include <variant>
 #include <vector>
+#include <type_traits>
 
 #include <libdog/Card.hpp>
 #include <libdog/PieceRef.hpp>
+#include <libdog/Constants.hpp>
+#include <libdog/BoundedVector.hpp>
 
 
 namespace libdog {
@@ -62,7 +67,7 @@ class Action {
 		Action(Card card) : Action(card, false) {
 		}
 
-		virtual bool is_valid() const {
+		bool is_valid() const {
 			if (card == None) {
 				return false;
 			}
@@ -105,7 +110,7 @@ class Give : public Action {
 		Give(Card card) : Give(card, false) {
 		}
 
-		virtual bool is_valid() const {
+		bool is_valid() const {
 			return (card != None);
 		}
 
@@ -117,7 +122,7 @@ class Discard : public Action {
 		Discard(Card card) : Action(card, false) {
 		}
 
-		virtual bool is_valid() const {
+		bool is_valid() const {
 			return (card != None);
 		}
 
@@ -132,28 +137,53 @@ class Start : public Action {
 		Start(Card card) : Start(card, false) {
 		}
 
-		virtual bool is_valid() const {
+		bool is_valid() const {
 			return Action::is_valid() && is_start_card(card);
 		}
 
 		friend bool operator==(const Start& a, const Start& b) = default;
 };
 
+// Packed into four bytes without padding, so that equal specifiers have equal bytes and can be hashed directly
 class MoveSpecifier {
+	private:
+		static int8_t narrow(int value) {
+			assert(INT8_MIN <= value && value <= INT8_MAX);
+			return static_cast<int8_t>(value);
+		}
+
 	public:
-		PieceRef piece_ref;
-		int count;
+		int8_t piece_player;
+		int8_t piece_rank;
+		int8_t count;
 		bool avoid_finish;
 
-		MoveSpecifier(PieceRef piece_ref, int count, bool avoid_finish) : piece_ref(piece_ref), count(count), avoid_finish(avoid_finish) {
+		// Values out of range of int8_t are rejected instead of wrapping around
+		MoveSpecifier(PieceRef piece_ref, int count, bool avoid_finish) : piece_player(narrow(piece_ref.player)), piece_rank(narrow(piece_ref.rank)), count(narrow(count)), avoid_finish(avoid_finish) {
 		}
 
 		MoveSpecifier(int piece_player, int piece_rank, int count, bool avoid_finish) : MoveSpecifier(PieceRef(piece_player, piece_rank), count, avoid_finish) {
 		}
 
+		MoveSpecifier() : MoveSpecifier(0, 0, 0, false) {
+		}
+
+		bool has_valid_piece_ref() const {
+			return IS_VALID_PLAYER(piece_player) && IS_VALID_PIECE_RANK(piece_rank);
+		}
+
+		PieceRef get_piece_ref() const {
+			return PieceRef(piece_player, piece_rank);
+		}
+
 		friend bool operator==(const MoveSpecifier& a, const MoveSpecifier& b) = default;
 };
 
+// Every valid piece reference and step count (at most a whole lap) fits into the packed fields
+static_assert(PLAYER_COUNT <= INT8_MAX && PIECE_COUNT <= INT8_MAX && PATH_LENGTH <= INT8_MAX);
+static_assert(sizeof(MoveSpecifier) == 4);
+static_assert(std::has_unique_object_representations_v<MoveSpecifier>);
+
 class Move : public Action {
 	private:
 
@@ -169,7 +199,7 @@ class Move : public Action {
 		Move(Card card, PieceRef piece_ref, int count, bool avoid_finish) : Move(card, piece_ref, count, avoid_finish, false) {
 		}
 
-		virtual bool is_valid() const {
+		bool is_valid() const {
 			if (card == None) {
 				return false;
 			}
@@ -183,7 +213,7 @@ class Move : public Action {
 				return false;
 			}
 
-			if (!move_specifier.piece_ref.is_valid()) {
+			if (!move_specifier.has_valid_piece_ref()) {
 				return false;
 			}
 
@@ -195,7 +225,7 @@ class Move : public Action {
 		}
 
 		PieceRef get_piece_ref() const {
-			return move_specifier.piece_ref;
+			return move_specifier.get_piece_ref();
 		}
 
 		int get_count() const {
@@ -209,37 +239,42 @@ class Move : public Action {
 		friend bool operator==(const Move& a, const Move& b) = default;
 };
 
+// Every move specifier of a seven moves at least one step
+#define MAX_MOVE_SPECIFIERS (7)
+
+using MoveSpecifiers = BoundedVector<MoveSpecifier, MAX_MOVE_SPECIFIERS>;
+
+static_assert(std::has_unique_object_representations_v<MoveSpecifiers>);
+
 class MoveMultiple : public Action {
 	private:
-		std::vector<MoveSpecifier> move_specifiers;
+		MoveSpecifiers move_specifiers;
 
 	public:
-		MoveMultiple(Card card, std::vector<MoveSpecifier> move_specifiers, bool joker) : Action(card, joker), move_specifiers(move_specifiers) {
+		MoveMultiple(Card card, const MoveSpecifiers& move_specifiers, bool joker) : Action(card, joker), move_specifiers(move_specifiers) {
 		}
 
 		MoveMultiple(Card card, MoveSpecifier move_specifier) : Action(card) {
 			move_specifiers.push_back(move_specifier);
 		}
 
-		MoveMultiple(Card card, std::vector<MoveSpecifier> move_specifiers) : MoveMultiple(card, move_specifiers, false) {
+		MoveMultiple(Card card, const MoveSpecifiers& move_specifiers) : MoveMultiple(card, move_specifiers, false) {
 		}
 
 		// TODO Check that the same piece is not referenced more than once in the move list (maybe not do this because the possible actions algorithm depends on that being allowed
-		virtual bool is_valid() const {
+		bool is_valid() const {
 			if (card != Seven) {
 				return false;
 			}
 
 			int sum_count = 0;
 
-			for (std::size_t i = 0; i < move_specifiers.size(); i++) {
-				MoveSpecifier move_specifier = move_specifiers.at(i);
-
+			for (const MoveSpecifier& move_specifier : move_specifiers) {
 				if (move_specifier.count <= 0) {
 					return false;
 				}
 
-				if (!move_specifier.piece_ref.is_valid()) {
+				if (!move_specifier.has_valid_piece_ref()) {
 					return false;
 				}
 
@@ -253,7 +288,7 @@ class MoveMultiple : public Action {
 			return Action::is_valid();
 		}
 
-		std::vector<MoveSpecifier> get_move_specifiers() const {
+		const MoveSpecifiers& get_move_specifiers() const {
 			return move_specifiers;
 		}
 
@@ -272,7 +307,7 @@ class Swap : public Action {
 		Swap(Card card, PieceRef piece_1, PieceRef piece_2) : Swap(card, piece_1, piece_2, false) {
 		}
 
-		virtual bool is_valid() const {
+		bool is_valid() const {
 			if (card != Jack) {
 				return false;
 			}
@@ -306,6 +341,9 @@ class Swap : public Action {
 
 typedef std::variant<Give, Discard, Start, Move, MoveMultiple, Swap> ActionVar;
 
+// Actions are plain values that can be copied with memcpy and stored in flat arrays
+static_assert(std::is_trivially_copyable_v<ActionVar>);
+
 #define VAR_IS(x, class_name) std::holds_alternative<class_name>(x)
 #define MATCH(x, class_name, bind_name) const class_name* bind_name = std::get_if<class_name>(x)
 #define MATCH_NON_CONST(x, class_name, bind_name) class_name* bind_name = std::get_if<class_name>(x)
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+#include <cassert>
+#include <stdexcept>
+
+#include "Action.hpp"
+
+
+namespace libdog {
+
+// Number of actions a buffer reserves up front. In random games, half of the positions have at most 3 possible actions
+// and 99% at most 74. The largest sets (about 3000 actions) stem from splitting a seven among many pieces when the hand
+// contains both a seven and a joker, the buffer grows for those.
+#define ACTION_BUFFER_INITIAL_CAPACITY (64)
+
+// Reusable output buffer for action generation. Clearing the buffer keeps the slots of the previously generated
+// actions alive, so that filling it again does not allocate any memory once the buffer has grown to the largest action
+// set it is used for.
+class ActionBuffer {
+	private:
+		std::vector<ActionVar> slots;
+		std::size_t count = 0;
+
+	public:
+		using value_type = ActionVar;
+		using size_type = std::size_t;
+		using const_iterator = const ActionVar*;
+		using iterator = const_iterator;
+
+		explicit ActionBuffer(std::size_t capacity) {
+			slots.reserve(capacity);
+		}
+
+		ActionBuffer() : ActionBuffer(ACTION_BUFFER_INITIAL_CAPACITY) {
+		}
+
+		std::size_t size() const {
+			return count;
+		}
+
+		bool empty() const {
+			return count == 0;
+		}
+
+		void clear() {
+			count = 0;
+		}
+
+		void push_back(const ActionVar& action) {
+			if (count < slots.size()) {
+				slots[count] = action;
+			} else {
+				slots.push_back(action);
+			}
+
+			count++;
+		}
+
+		const ActionVar& operator[](std::size_t i) const {
+			assert(i < count);
+			return slots[i];
+		}
+
+		const ActionVar& at(std::size_t i) const {
+			if (i >= count) {
+				throw std::out_of_range("ActionBuffer::at");
+			}
+
+			return slots[i];
+		}
+
+		const ActionVar* begin() const {
+			return slots.data();
+		}
+
+		const ActionVar* end() const {
+			return slots.data() + count;
+		}
+
+		// Moves the actions out of the buffer, leaving it empty
+		std::vector<ActionVar> release() {
+			slots.erase(slots.begin() + count, slots.end());
+			count = 0;
+			return std::move(slots);
+		}
+};
+
+}
@@ -5,6 +5,7 @@
 #include <memory>
 #include <utility>
 #include <cassert>
+#include <type_traits>
 
 #include "Piece.hpp"
 #include "PieceRef.hpp"
@@ -13,21 +14,59 @@
 #include "Notation.hpp"
 #include "Constants.hpp"
 #include "Action.hpp"
+#include "BoundedVector.hpp"
+#include "Zobrist.hpp"
 
 
 namespace libdog {
 
 using BoardStateRepr = std::array<int, PIECE_COUNT * PLAYER_COUNT>;
 
-class OneStep {
+// A seven moves at most 7 pieces and sends at most 7 pieces back to their kennels, which is the largest number of
+// primitive changes a single action can cause. Nested journals share the entries of the outermost one, so this is also
+// the limit for all changes recorded until the outermost journal ends.
+#define JOURNAL_CAPACITY (4 * MAX_MOVE_SPECIFIERS)
+
+// Content of an empty slot
+#define NO_PIECE (-1)
+
+// Largest number of steps a single card moves a piece forwards (king) and backwards (four)
+#define STRIKING_RANGE_FORWARD (13)
+#define STRIKING_RANGE_BACKWARD (4)
+
+// Pieces are identified by Piece::get_id()
+using PieceId = int8_t;
+
+// Primitive change of the board that can be reverted
+class JournalEntry {
 	public:
-		PiecePtr piece;
-		BoardPosition previous_position;
-		bool was_blocking;
-		PiecePtr previous_occupant;
+		PieceId piece;
+		// Second piece of a swap, NO_PIECE if the entry describes a move
+		int8_t swapped_piece;
+		// Encoded position of the piece before the move
+		int8_t previous_position;
+		bool previous_blocking;
+};
 
-		OneStep(PiecePtr piece, BoardPosition previous_position, bool was_blocking,  PiecePtr previous_occupant) : piece(piece), previous_position(previous_position), was_blocking(was_blocking), previous_occupant(previous_occupant) {;
-		}
+using Journal = BoundedVector<JournalEntry, JOURNAL_CAPACITY>;
+
+// Static evaluation features of every player
+class BoardFeatures {
+	public:
+		// Sum of calc_steps_to_start() over the pieces on the path, a piece blocking its start has a whole lap to go
+		std::array<int, PLAYER_COUNT> distance_to_finish = {};
+		// Steps the pieces made since leaving the kennel, pieces in the finish count as having gone around the whole
+		// path
+		std::array<int, PLAYER_COUNT> progress = {};
+		std::array<int, PLAYER_COUNT> kennel_count = {};
+		std::array<int, PLAYER_COUNT> finish_count = {};
+		// Pieces blocking the start of the player
+		std::array<int, PLAYER_COUNT> blocking_count = {};
+		// Pieces on the path that a piece of the other team can reach with a single card, not considering pieces in
+		// between. Blocking pieces are safe.
+		std::array<int, PLAYER_COUNT> threatened_count = {};
+
+		friend bool operator==(const BoardFeatures& a, const BoardFeatures& b) = default;
 };
 
 class BoardState {
@@ -36,52 +75,46 @@ class BoardState {
 
 		std::array<std::array<Piece, PIECE_COUNT>, PLAYER_COUNT> pieces;
 
-		std::array<PiecePtr, PATH_LENGTH> path;
-		std::array<std::array<PiecePtr, FINISH_LENGTH>, PLAYER_COUNT> finishes;
-		std::array<std::array<PiecePtr, KENNEL_SIZE>, PLAYER_COUNT> kennels;
-
-		std::vector<OneStep> one_step_undo_stack;
-		bool undo_stack_activated = false;
+		// Slots hold the id of the piece that occupies them or NO_PIECE. Since there are no pointers into the object,
+		// a board state can be copied with memcpy.
+		std::array<PieceId, PATH_LENGTH> path;
+		std::array<std::array<PieceId, FINISH_LENGTH>, PLAYER_COUNT> finishes;
+		std::array<std::array<PieceId, KENNEL_SIZE>, PLAYER_COUNT> kennels;
 
 		BoardState();
 
-		BoardState(const BoardState& other);
-
-		BoardState& operator=(const BoardState& other);
-
 		friend bool operator==(const BoardState& a, const BoardState& b);
 
 		void reset();
 
 		PiecePtr ref_to_piece(const PieceRef& piece_ref) const;
 
-		PiecePtr& ref_to_piece_ptr_ref(const PieceRef& piece_ref);
-
 		BoardPosition ref_to_pos(const PieceRef& piece_ref) const;
 
-		bool get_kennel_piece(int player, PiecePtr** result);
+		PiecePtr id_to_piece(int piece_id) const;
 
-		void start_piece(PiecePtr& piece);
+		bool get_kennel_piece(int player, PiecePtr& result);
 
-		PiecePtr& get_piece(int path_idx);
+		void start_piece(PiecePtr piece);
 
-		const PiecePtr& get_piece(BoardPosition position) const;
+		// Returns nullptr if the position is empty
+		PiecePtr get_piece(int path_idx) const;
 
-		PiecePtr& get_piece(BoardPosition position);
+		PiecePtr get_piece(BoardPosition position) const;
 
-		PiecePtr& get_start(int player);
+		PiecePtr get_start(int player) const;
 
 		void send_to_kennel(int from_path_idx, int count);
 
-		void place_at_kennel(PiecePtr& piece);
+		void place_at_kennel(PiecePtr piece);
 
-		void move_piece(PiecePtr& piece, BoardPosition position, bool blocking = false);
+		void move_piece(PiecePtr piece, BoardPosition position, bool blocking = false);
 
-		bool move_piece(PiecePtr& piece, int count, bool avoid_finish, bool modify_state, bool remove_all_on_way);
+		bool move_piece(PiecePtr piece, int count, bool avoid_finish, bool modify_state, bool remove_all_on_way);
 
-		void undo_one_step();
+		void swap_pieces(PiecePtr piece1, PiecePtr piece2);
 
-		void swap_pieces(PiecePtr& piece1, PiecePtr& piece2);
+		void set_blocking(PiecePtr piece, bool blocking);
 
 		bool check_finish_full(int player);
 
@@ -89,14 +122,76 @@ class BoardState {
 
 		bool start_piece(int player, bool modify_state = true);
 
-		bool move_multiple_pieces(std::vector<MoveSpecifier> move_actions, bool modify_state);
+		bool move_multiple_pieces(const MoveSpecifiers& move_actions, bool modify_state);
 
-		bool swap_pieces(PiecePtr& piece_1, PiecePtr& piece_2, bool modify_state);
+		// Starts recording all changes of piece positions in the journal, which is owned by the caller and has to outlive
+		// the recording. Returns a mark that can be used to revert the changes. Copies of the board state made while
+		// recording must not be modified, they would record into the same journal.
+		std::size_t begin_journal(Journal& journal);
+
+		// Starts a journal nested into the one that is recording. Nested journals share its entries, so all of them
+		// together hold at most JOURNAL_CAPACITY changes, which is enough for a single action. Recording more throws
+		// std::length_error before the board is changed.
+		std::size_t begin_journal();
+
+		bool is_journaling() const {
+			return journal_depth > 0;
+		}
+
+		// Stops recording and keeps the changes made since the mark. Once the outermost journal is committed, the
+		// changes stay in it and can be reverted with revert_changes().
+		void commit_journal(std::size_t mark);
+
+		// Reverts changes that were taken from the journal. All changes made afterwards have to be reverted first.
+		void revert_changes(const Journal& changes);
+
+		// Stops recording and reverts the changes made since the mark
+		void rollback_journal(std::size_t mark);
+
+		bool swap_pieces(PiecePtr piece_1, PiecePtr piece_2, bool modify_state);
 
 		bool try_enter_finish(int player, int from_path_idx, int count, bool piece_blocking, BoardPosition& position_result, int& count_on_path_result);
 
 		BoardStateRepr get_repr() const;
 
+		// Zobrist hash of the piece positions, maintained incrementally. Equal positions have equal hashes.
+		uint64_t hash() const {
+			return zobrist_hash;
+		}
+
+		uint64_t compute_hash() const;
+
+		// Occupancy of the path by the pieces of a player, bit i corresponds to path index i
+		uint64_t get_path_mask(int player) const {
+			return path_masks[player];
+		}
+
+		// Occupancy of the path by pieces of any player
+		uint64_t get_path_mask() const {
+			return path_masks[0] | path_masks[1] | path_masks[2] | path_masks[3];
+		}
+
+		// Path positions that are occupied by blocking pieces
+		uint64_t get_blocking_mask() const {
+			return blocking_mask;
+		}
+
+		// Occupancy of the finish of a player, bit i corresponds to finish index i
+		uint8_t get_finish_mask(int player) const {
+			return finish_masks[player];
+		}
+
+		// Occupancy of the kennel of a player, bit i corresponds to kennel index i
+		uint8_t get_kennel_mask(int player) const {
+			return kennel_masks[player];
+		}
+
+		// All features except threatened_count are maintained incrementally, the latter is derived from the occupancy
+		// masks with a few bit operations
+		BoardFeatures features() const;
+
+		BoardFeatures compute_features() const;
+
 		bool check_state() const;
 
 		friend std::ostream& operator<<(std::ostream& os, BoardState const& obj) {
@@ -104,6 +199,43 @@ class BoardState {
 		}
 
 	private:
+		uint64_t zobrist_hash = 0;
+
+		// Journal that is recording, not part of the state. Keeping it outside keeps the state small to copy.
+		Journal* journal = nullptr;
+		int journal_depth = 0;
+
+		void record(const JournalEntry& entry);
+
+		void revert(const JournalEntry& entry);
+
+		// Piece indices of every player ordered by rank, maintained whenever a piece changes its position
+		std::array<std::array<int, PIECE_COUNT>, PLAYER_COUNT> rank_order;
+		// Progress of every piece along the board, the piece with the largest progress has rank 0
+		std::array<std::array<int, PIECE_COUNT>, PLAYER_COUNT> rank_progress;
+
+		void update_rank(const Piece& piece);
+
+		// Occupancy masks, maintained together with the slot arrays
+		std::array<uint64_t, PLAYER_COUNT> path_masks;
+		std::array<uint8_t, PLAYER_COUNT> finish_masks;
+		std::array<uint8_t, PLAYER_COUNT> kennel_masks;
+		uint64_t blocking_mask;
+
+		void toggle_occupancy(const Piece& piece);
+
+		// Maintained together with the occupancy masks, threatened_count is not used
+		BoardFeatures piece_features;
+
+		// Adds (sign 1) or removes (sign -1) the contribution of a piece to the features
+		void update_features(const Piece& piece, int sign);
+
+		void reset_occupancy();
+
+		const PieceId& get_slot(const BoardPosition& position) const;
+
+		PieceId& get_slot(const BoardPosition& position);
+
 		bool check_move_on_path(int from_path_idx, int count, BoardPosition& position_result);
 
 		bool check_move_in_finish(int player, int from_finish_idx, int count, BoardPosition& position_result);
@@ -120,9 +252,11 @@ class BoardState {
 
 		bool check_block(int from_path_idx, int count);
 
-		bool move_multiple_pieces_naive(std::vector<MoveSpecifier> move_actions);
+		bool move_multiple_pieces_naive(const MoveSpecifiers& move_actions);
 
 		std::string to_str() const;
 };
 
+static_assert(std::is_trivially_copyable_v<BoardState>);
+
 }
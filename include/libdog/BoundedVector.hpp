@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <cassert>
+#include <type_traits>
+
+
+namespace libdog {
+
+// Vector with inline storage for at most N elements. As long as T is trivially copyable, so is the vector, which
+// allows it to be stored in flat arrays and copied with memcpy. Slots past the end always hold T(), so that vectors with
+// equal elements also have equal bytes.
+template<typename T, std::size_t N>
+class BoundedVector {
+	private:
+		std::array<T, N> elements = {};
+		std::conditional_t<(N <= UINT8_MAX), uint8_t, std::size_t> count = 0;
+
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using iterator = T*;
+		using const_iterator = const T*;
+
+		BoundedVector() = default;
+
+		BoundedVector(std::initializer_list<T> list) {
+			assert(list.size() <= N);
+
+			for (const T& element : list) {
+				push_back(element);
+			}
+		}
+
+		static constexpr std::size_t capacity() {
+			return N;
+		}
+
+		std::size_t size() const {
+			return count;
+		}
+
+		bool empty() const {
+			return count == 0;
+		}
+
+		bool full() const {
+			return count == N;
+		}
+
+		void clear() {
+			std::fill(elements.begin(), elements.begin() + count, T());
+			count = 0;
+		}
+
+		void push_back(const T& element) {
+			assert(count < N);
+			elements[count] = element;
+			count++;
+		}
+
+		void pop_back() {
+			assert(count > 0);
+			count--;
+			elements[count] = T();
+		}
+
+		T& back() {
+			assert(count > 0);
+			return elements[count - 1];
+		}
+
+		const T& back() const {
+			assert(count > 0);
+			return elements[count - 1];
+		}
+
+		T& operator[](std::size_t i) {
+			assert(i < count);
+			return elements[i];
+		}
+
+		const T& operator[](std::size_t i) const {
+			assert(i < count);
+			return elements[i];
+		}
+
+		const T& at(std::size_t i) const {
+			if (i >= count) {
+				throw std::out_of_range("BoundedVector::at");
+			}
+
+			return elements[i];
+		}
+
+		T* begin() {
+			return elements.data();
+		}
+
+		T* end() {
+			return elements.data() + count;
+		}
+
+		const T* begin() const {
+			return elements.data();
+		}
+
+		const T* end() const {
+			return elements.data() + count;
+		}
+
+		friend bool operator==(const BoundedVector& a, const BoundedVector& b) {
+			return std::equal(a.begin(), a.end(), b.begin(), b.end());
+		}
+};
+
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <libdog/Card.hpp>
+
+
+// Number of bits of the count of one kind of card, at most 15 cards of a kind fit into a hand
+#define CARD_HAND_COUNT_BITS (4)
+#define CARD_HAND_COUNT_MASK ((UINT64_C(1) << CARD_HAND_COUNT_BITS) - 1)
+
+namespace libdog {
+
+// Unordered set of cards (e.g. a hand) that stores the number of cards of every kind in a single word. Checking,
+// adding and removing a card and enumerating the distinct cards do not depend on the number of cards.
+class CardHand {
+	private:
+		// Count of card c in the bits [c * CARD_HAND_COUNT_BITS, (c + 1) * CARD_HAND_COUNT_BITS)
+		uint64_t counts = 0;
+		// Bit c is set if the hand contains at least one card c
+		uint16_t card_mask = 0;
+		uint16_t card_count = 0;
+
+		static int get_shift(Card card) {
+			return card * CARD_HAND_COUNT_BITS;
+		}
+
+	public:
+		CardHand() = default;
+
+		explicit CardHand(const std::vector<Card>& cards) {
+			for (Card card : cards) {
+				add(card);
+			}
+		}
+
+		std::size_t size() const {
+			return card_count;
+		}
+
+		bool empty() const {
+			return card_count == 0;
+		}
+
+		bool contains(Card card) const {
+			return (card_mask >> card) & 1;
+		}
+
+		int count(Card card) const {
+			return (counts >> get_shift(card)) & CARD_HAND_COUNT_MASK;
+		}
+
+		// Bit c is set if the hand contains the card c, iterating over the set bits yields the distinct cards in
+		// ascending order
+		uint16_t get_card_mask() const {
+			return card_mask;
+		}
+
+		void add(Card card) {
+			assert(card != None);
+			assert(count(card) < static_cast<int>(CARD_HAND_COUNT_MASK));
+
+			counts += UINT64_C(1) << get_shift(card);
+			card_mask |= 1 << card;
+			card_count++;
+		}
+
+		void remove(Card card) {
+			assert(contains(card));
+
+			counts -= UINT64_C(1) << get_shift(card);
+			card_count--;
+
+			if (count(card) == 0) {
+				card_mask &= ~(1 << card);
+			}
+		}
+
+		// Moves all cards to dest
+		void move_to(CardHand& dest) {
+#ifndef NDEBUG
+			// Adding the counts as a whole is only valid as long as no count overflows into the next kind
+			for (int card = Ace; card <= Joker; card++) {
+				assert(count(static_cast<Card>(card)) + dest.count(static_cast<Card>(card)) <= static_cast<int>(CARD_HAND_COUNT_MASK));
+			}
+#endif
+
+			dest.counts += counts;
+			dest.card_mask |= card_mask;
+			dest.card_count += card_count;
+
+			clear();
+		}
+
+		// Removes all cards and returns them in ascending order
+		template<typename OutputIt>
+		OutputIt take_all(OutputIt out) {
+			for (uint16_t mask = card_mask; mask != 0; mask &= mask - 1) {
+				Card card = static_cast<Card>(std::countr_zero(mask));
+
+				for (int i = count(card); i > 0; i--) {
+					*out++ = card;
+				}
+			}
+
+			clear();
+			return out;
+		}
+
+		void clear() {
+			counts = 0;
+			card_mask = 0;
+			card_count = 0;
+		}
+
+		// Cards in ascending order
+		std::vector<Card> get_cards() const;
+
+		std::string to_str() const;
+
+		friend bool operator==(const CardHand& a, const CardHand& b) {
+			return a.counts == b.counts;
+		}
+
+		friend std::ostream& operator<<(std::ostream& os, CardHand const& obj) {
+			  return os << obj.to_str();
+		}
+};
+
+}
@@ -2,38 +2,34 @@
 
 #include <vector>
 #include <algorithm>
-#include <random>
 #include <sstream>
 
 #include <libdog/Card.hpp>
+#include <libdog/CardHand.hpp>
+#include <libdog/Rng.hpp>
 
 
 using namespace std;
 
 namespace libdog {
 
-static default_random_engine get_rng() {
-#ifndef NDEBUG
-	return default_random_engine(0);
-#else
-	random_device r;
-	return default_random_engine(r());
-#endif
-}
-
 // TODO Track suites as well to make library usable for full game interfaces
 class CardStack {
+	friend class CardsState;
+
 	private:
+		// The stack consists of cards[top], cards[top + 1], ... The cards before top were already taken from the front,
+		// this way taking cards does not shift the remaining ones.
 		vector<Card> cards;
-		default_random_engine rng;
+		size_t top = 0;
 
 		void remove(Card card);
 
-	public:
-		CardStack(vector<Card> cards, default_random_engine rng);
+		// Drops the taken cards once the stack is empty, the vector keeps its capacity for the next cards
+		void reset_if_empty();
 
-		CardStack(vector<Card> cards) : CardStack(cards, get_rng()) {
-		}
+	public:
+		CardStack(vector<Card> cards);
 
 		CardStack() : CardStack(vector<Card>()) {
 		}
@@ -50,12 +46,24 @@ class CardStack {
 
 		void move_to(CardStack& dest, Card card);
 
-		void shuffle();
+		// Moves the first count cards to the hand
+		void deal_to(CardHand& dest, size_t count);
+
+		void push_back(Card card);
+
+		// Removes and returns the card added last with push_back() or move_to()
+		Card pop_back();
+
+		void shuffle(Rng& rng);
 
 		vector<Card> get_cards() const;
 
 		string to_str() const;
 
+		friend bool operator==(const CardStack& a, const CardStack& b) {
+			return std::equal(a.cards.begin() + a.top, a.cards.end(), b.cards.begin() + b.top, b.cards.end());
+		}
+
 		friend ostream& operator<<(ostream& os, CardStack const& obj) {
 			  return os << obj.to_str();
 		}
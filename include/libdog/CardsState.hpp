@@ -2,10 +2,13 @@
 
 #include <array>
 #include <cassert>
+#include <random>
 
 #include <libdog/Card.hpp>
+#include <libdog/CardHand.hpp>
 #include <libdog/CardStack.hpp>
 #include <libdog/Constants.hpp>
+#include <libdog/Rng.hpp>
 
 
 namespace libdog {
@@ -28,6 +31,16 @@ static void add_suite(vector<Card>& cards) {
 	cards.push_back(King);
 }
 
+// Seed of the card generator if none is given. Debug builds always use the same seed.
+static uint64_t get_random_seed() {
+#ifndef NDEBUG
+	return 0;
+#else
+	std::random_device r;
+	return (static_cast<uint64_t>(r()) << 32) | r();
+#endif
+}
+
 static vector<Card> get_dog_card_set() {
 	vector<Card> result;
 
@@ -44,11 +57,16 @@ static vector<Card> get_dog_card_set() {
 
 class CardsState {
 	public:
-		explicit CardsState(vector<Card> cards);
+		explicit CardsState(vector<Card> cards) : CardsState(cards, Rng(get_random_seed())) {
+		}
+
+		// The generator is used whenever the discarded cards are shuffled back into the deck
+		CardsState(vector<Card> cards, const Rng& rng);
 
 		CardsState() : CardsState(get_dog_card_set()) {
 		}
 
+		// Throws std::length_error if the deck and the discarded cards together run out
 		void hand_out_cards(int count);
 
 		[[nodiscard]]
@@ -56,6 +74,18 @@ class CardsState {
 
 		void discard(int player, Card card);
 
+		// Reverts discard() of a card the player had in their hand. given_card is the result of get_given_card() for
+		// the team mate of the player before the card was discarded.
+		void undo_discard(int player, Card given_card);
+
+		// Bit c is set if the player has the card c in their hand, see CardHand::get_card_mask()
+		[[nodiscard]]
+		uint16_t get_hand_card_mask(int player) const;
+
+		// Total number of cards in the hands of all players
+		[[nodiscard]]
+		size_t get_hand_card_count() const;
+
 		[[nodiscard]]
 		bool hands_empty() const;
 
@@ -67,6 +97,28 @@ class CardsState {
 
 		void give_card(int player, Card card);
 
+		// Reverts give_card()
+		void undo_give_card(int player);
+
+		// Card the player gave to their team mate in the current round as long as the team mate did not play a card of
+		// the same kind since, None otherwise. Only the player themselves knows this card.
+		[[nodiscard]]
+		Card get_given_card(int player) const;
+
+		// Redistributes all cards the observer cannot see (the hands and give buffers of the other players and the
+		// deck) randomly, keeping the number of cards in each of them. Cards known to the observer stay in place.
+		void sample_determinization(int observer, Rng& rng);
+
+		// Generator of all shuffles of the deck. As it is part of the state, copies of the state shuffle the same way.
+		Rng& get_rng() {
+			return rng;
+		}
+
+		// Hash of the contents of the hands and give buffers and the number of cards in the deck. The order of the
+		// cards within a stack does not matter.
+		[[nodiscard]]
+		uint64_t hash() const;
+
 		bool give_buffer_full(int player);
 
 		bool give_buffer_full();
@@ -76,21 +128,29 @@ class CardsState {
 		[[nodiscard]]
 		string to_str() const;
 
+		friend bool operator==(const CardsState& a, const CardsState& b) {
+			return a.hands == b.hands && a.give_buffer == b.give_buffer && a.deck == b.deck && a.discarded == b.discarded && a.given_cards == b.given_cards && a.rng == b.rng;
+		}
+
 		friend ostream& operator<<(ostream& os, CardsState const& obj) {
 			  return os << obj.to_str();
 		}
 
 	private:
-		array<CardStack, PLAYER_COUNT> hands;
-		array<CardStack, PLAYER_COUNT> give_buffer;
+		array<CardHand, PLAYER_COUNT> hands;
+		array<CardHand, PLAYER_COUNT> give_buffer;
 
 		CardStack deck;
 		CardStack discarded;
 
-		CardStack& get_hand(int player);
+		array<Card, PLAYER_COUNT> given_cards;
+
+		Rng rng;
+
+		CardHand& get_hand(int player);
 
 		[[nodiscard]]
-		const CardStack& get_hand(int player) const;
+		const CardHand& get_hand(int player) const;
 };
 
 }
@@ -6,16 +6,38 @@
 #include <array>
 #include <memory>
 #include <vector>
-#include <unordered_set>
+#include <optional>
 #include <cassert>
 
 #include "BoardState.hpp"
 #include "CardsState.hpp"
 #include "Action.hpp"
+#include "ActionBuffer.hpp"
 
 
 namespace libdog {
 
+// Everything that is needed to revert an action with DogGame::undo()
+class UndoRecord {
+	public:
+		// Player whose turn it was, the played card was taken from their hand
+		int player;
+		bool is_give;
+		// Whether the played card was taken from the hand
+		bool from_hand;
+		// Card the team mate of the player gave to the player, see CardsState::get_given_card()
+		Card given_card;
+
+		bool give_phase_done;
+		int next_hand_size;
+
+		Journal board_changes;
+
+		// Only set if the action concluded the give phase or the round, in which case cards moved between many stacks
+		// (and the deck might have been shuffled). Holds the cards before the action.
+		std::optional<CardsState> cards_state;
+};
+
 class DogGame {
 	public:
 		int player_turn;
@@ -37,6 +59,15 @@ class DogGame {
 
 		void reset_with_deck(const std::vector<Card>& cards);
 
+		// Resets the board and deals from a shuffled set of cards. The game only depends on the seed, including the
+		// reshuffles of the discarded cards.
+		void reset_with_seed(uint64_t seed);
+
+		// Generator of all shuffles of the game, it is part of cards_state
+		Rng& get_rng() {
+			return cards_state.get_rng();
+		}
+
 		void load_board(const std::string& notation_str);
 
 		// -1 ... undecided (game not concluded yet)
@@ -49,14 +80,35 @@ class DogGame {
 
 		bool play_notation(int player, std::string notation_str, bool modify_state = true);
 
-		bool play(int player, ActionVar action, bool modify_state = true, bool common_checks = true);
+		bool play(int player, const ActionVar& action, bool modify_state = true, bool common_checks = true);
+
+		// Plays a legal action of the player whose turn it is. The returned record reverts the action when passed to
+		// undo(). Actions have to be undone in reverse order.
+		UndoRecord apply(const ActionVar& action);
+
+		void undo(const UndoRecord& record);
+
+		// Hash of the board, the cards (see CardsState::hash()), the player whose turn it is, the give phase and the size
+		// of the next handout. Used as the key of a TranspositionTable.
+		[[nodiscard]]
+		uint64_t hash() const;
 
 		std::vector<ActionVar> get_possible_actions(int player);
 
+		// Same as above, but writes the actions into a buffer owned by the caller (the buffer is cleared first)
+		void get_possible_actions(int player, ActionBuffer& out);
+
 		std::vector<ActionVar> possible_actions_for_card(int player, Card card, bool is_joker);
 
+		// Same as above, but appends the actions to a buffer owned by the caller
+		void possible_actions_for_card(int player, Card card, bool is_joker, ActionBuffer& out);
+
 		int switch_to_team_mate_if_done(int player);
 
+		// Returns true if the player can play any of their hand cards. Stops at the first legal action, so this is much
+		// cheaper than generating all possible actions.
+		bool has_legal_card_play(int player);
+
 	private:
 		bool canadian_rule;
 
@@ -88,54 +140,29 @@ class DogGame {
 
 		bool try_play(int player, const Swap& swap, bool modify_state = true);
 
-		std::vector<ActionVar> possible_gives(int player);
-
-		std::vector<ActionVar> possible_discards(int player);
+		void possible_gives(int player, ActionBuffer& out);
 
-		std::vector<ActionVar> possible_starts(int player, Card card, bool is_joker);
+		void possible_discards(int player, ActionBuffer& out);
 
-		std::vector<ActionVar> possible_moves(int player, Card card, int count, bool is_joker);
+		void possible_starts(int player, Card card, bool is_joker, ActionBuffer& out);
 
-		struct action_state_equal_to {
-			bool operator()(const std::tuple<ActionVar, BoardStateRepr> &a, const std::tuple<ActionVar, BoardStateRepr> &b) const {
-				return std::get<1>(a) == std::get<1>(b);
-			}
-		};
+		void possible_moves(int player, Card card, int count, bool is_joker, ActionBuffer& out);
 
-		// TODO Optimization: Play around with different hashes and benchmark them on a random set of games
-		struct action_state_hash {
-			size_t operator()(const std::tuple<ActionVar, BoardStateRepr> &t) const {
-				const BoardStateRepr& repr = std::get<1>(t);
-				int offset = PIECE_COUNT - 1;
-				return
-					repr[0 * PIECE_COUNT + offset - 0] * repr[0 * PIECE_COUNT + offset - 0] +
-					repr[1 * PIECE_COUNT + offset - 0] * repr[1 * PIECE_COUNT + offset - 0] +
-					repr[2 * PIECE_COUNT + offset - 0] * repr[2 * PIECE_COUNT + offset - 0] +
-					repr[3 * PIECE_COUNT + offset - 0] * repr[3 * PIECE_COUNT + offset - 0] +
-					repr[0 * PIECE_COUNT + offset - 1] * repr[0 * PIECE_COUNT + offset - 1] +
-					repr[1 * PIECE_COUNT + offset - 1] * repr[1 * PIECE_COUNT + offset - 1] +
-					repr[2 * PIECE_COUNT + offset - 1] * repr[2 * PIECE_COUNT + offset - 1] +
-					repr[3 * PIECE_COUNT + offset - 1] * repr[3 * PIECE_COUNT + offset - 1] +
-					repr[0 * PIECE_COUNT + offset - 2] * repr[0 * PIECE_COUNT + offset - 2] +
-					repr[1 * PIECE_COUNT + offset - 2] * repr[1 * PIECE_COUNT + offset - 2] +
-					repr[2 * PIECE_COUNT + offset - 2] * repr[2 * PIECE_COUNT + offset - 2] +
-					repr[3 * PIECE_COUNT + offset - 2] * repr[3 * PIECE_COUNT + offset - 2];
-			}
-		};
+		void possible_move_multiples(int player, Card card, int count, bool is_joker, ActionBuffer& out);
 
-		typedef std::unordered_set<std::tuple<ActionVar, BoardStateRepr>, action_state_hash, action_state_equal_to> my_set;
+		void possible_swaps(int player, Card card, bool is_joker, ActionBuffer& out);
 
-		void descend_move(my_set& s, int player, Card card, BoardState& board, int count, bool is_joker, std::vector<std::tuple<PieceRef, PiecePtr>> pieces, std::vector<MoveSpecifier>& move_specifiers, PiecePtr& piece_ptr, PieceRef& piece_ref, PiecePtr& piece, bool avoid_finish);
+		void get_possible_card_plays(int player, ActionBuffer& out);
 
-		void _possible_move_multiples(my_set& s, int player, Card card, BoardState& board, int count, bool is_joker, std::vector<std::tuple<PieceRef, PiecePtr>> pieces, std::vector<MoveSpecifier>& move_specifiers);
+		bool has_possible_start(int player, Card card, bool is_joker);
 
-		void _possible_move_multiples_iter(my_set& s, int player, Card card, BoardState& board, size_t count, bool is_joker, std::vector<std::tuple<PieceRef, PiecePtr>> pieces);
+		bool has_possible_move(int player, Card card, int count, bool is_joker);
 
-		std::vector<ActionVar> possible_move_multiples(int player, Card card, int count, bool is_joker);
+		bool has_possible_move_multiple(int player, int count);
 
-		std::vector<ActionVar> possible_swaps(int player, Card card, bool is_joker);
+		bool has_possible_swap(int player, Card card, bool is_joker);
 
-		std::vector<ActionVar> get_possible_card_plays(int player);
+		bool has_possible_action_for_card(int player, Card card, bool is_joker);
 
 		std::string to_str() const;
 
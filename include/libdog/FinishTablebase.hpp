@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BoardState.hpp"
+#include "Constants.hpp"
+
+
+// Cells are numbered by the distance to the start for path positions (0 ... region), followed by the finish positions.
+// Masks of the cells have to fit into 32 bits.
+#define FINISH_TABLEBASE_MAX_REGION (32 - 1 - FINISH_LENGTH)
+#define FINISH_TABLEBASE_DEFAULT_REGION (PATH_SECTION_LENGTH)
+
+// Stored values are expected numbers of turns in units of 1/FINISH_TABLEBASE_SCALE
+#define FINISH_TABLEBASE_SCALE (256)
+#define FINISH_TABLEBASE_UNSOLVABLE (UINT16_MAX)
+
+namespace libdog {
+
+// Expected number of turns a player needs to bring all of their pieces into the finish, for every position in which
+// all pieces are in the finish or on the last region path positions before it.
+//
+// The table is computed by value iteration from the finished position backwards. Every turn the player draws a random
+// card (with the frequencies of the card set) and plays the move with that card that minimizes the expected number of
+// remaining turns. If the card cannot be played, the turn is lost. Moves follow the rules of BoardState::move_piece()
+// and BoardState::move_multiple_pieces(). The following is not modelled:
+// - pieces of other players, so jacks are never playable
+// - moves that leave the region, e.g. passing the start or hitting an own piece, are not considered
+//
+// Positions are indexed by the rank of the set of occupied cells in the combinatorial number system, which is a
+// minimal perfect hash. Tables can be written to a file and memory-mapped again.
+class FinishTablebase {
+	public:
+		FinishTablebase() = default;
+
+		FinishTablebase(const FinishTablebase&) = delete;
+		FinishTablebase& operator=(const FinishTablebase&) = delete;
+
+		FinishTablebase(FinishTablebase&& other) noexcept;
+		FinishTablebase& operator=(FinishTablebase&& other) noexcept;
+
+		~FinishTablebase();
+
+		static FinishTablebase generate(int region = FINISH_TABLEBASE_DEFAULT_REGION);
+
+		// Maps a file written by save(), returns false if the file cannot be read or is not a valid table
+		bool load(const std::string& path);
+
+		bool save(const std::string& path) const;
+
+		// Returns false if not all pieces of the player are within the region and the finish or if the finish cannot
+		// be reached. Pieces of other players are ignored.
+		bool probe(const BoardState& board_state, int player, double& expected_turns) const;
+
+		// Index of the position with pieces on the given cells, which have to be distinct
+		static uint32_t get_index(std::array<int, PIECE_COUNT> cells);
+
+		// Number of positions for the region
+		static std::size_t get_position_count(int region);
+
+		int get_region() const {
+			return region;
+		}
+
+		std::size_t size() const {
+			return value_count;
+		}
+
+		// Stored value of the position with the given index
+		uint16_t get_value(uint32_t idx) const {
+			return values[idx];
+		}
+
+	private:
+		int region = 0;
+
+		// Either points into owned_values or into the mapped file
+		const uint16_t* values = nullptr;
+		std::size_t value_count = 0;
+
+		std::vector<uint16_t> owned_values;
+
+		void* mapping = nullptr;
+		std::size_t mapping_size = 0;
+
+		void unmap();
+};
+
+}
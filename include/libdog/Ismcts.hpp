@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "DogGame.hpp"
+#include "Action.hpp"
+#include "ActionBuffer.hpp"
+#include "Playout.hpp"
+#include "Rng.hpp"
+
+
+#define ISMCTS_NO_NODE (UINT32_MAX)
+
+// The node pool is allocated in chunks of 2^ISMCTS_NODE_CHUNK_BITS nodes
+#define ISMCTS_NODE_CHUNK_BITS (12)
+#define ISMCTS_NODE_CHUNK_SIZE (UINT32_C(1) << ISMCTS_NODE_CHUNK_BITS)
+
+namespace libdog {
+
+class IsmctsConfig {
+	public:
+		// The search stops after this many iterations, 0 means no limit
+		uint64_t iterations = 1000;
+		// The search stops after this many seconds, 0 means no limit. At least one of the budgets has to be set.
+		double time_limit = 0;
+		// Exploration constant of UCT
+		double exploration = 0.7;
+		uint64_t seed = 0;
+		PlayoutPolicy rollout_policy = uniform_random_policy;
+		// Rollouts that are not decided within this many moves count as a draw, 0 means no limit
+		int rollout_max_moves = 0;
+		// Worker threads that grow the same tree, 0 means one thread per hardware thread
+		unsigned thread_count = 1;
+		// Number of visits without reward a worker adds to every node on its current path, so that the other workers
+		// prefer different paths until the iteration is backpropagated
+		uint64_t virtual_loss = 1;
+		// Capacity of the node pool, the tree stops growing when it is exhausted. The memory of the pool is allocated in
+		// chunks of ISMCTS_NODE_CHUNK_SIZE nodes as the tree grows.
+		uint32_t max_nodes = 1 << 20;
+};
+
+class IsmctsActionStats {
+	public:
+		ActionVar action;
+		uint64_t visits;
+		// Number of iterations in which the action was legal in the sampled game
+		uint64_t availability;
+		// Average reward for the team of the searching player (1 for a win, 0 for a loss)
+		double mean_value;
+};
+
+class IsmctsResult {
+	public:
+		// Statistics of the actions of the searching player
+		std::vector<IsmctsActionStats> actions;
+		uint64_t iterations = 0;
+		// Number of nodes in the tree including the root
+		uint32_t node_count = 0;
+
+		// Most visited action
+		const ActionVar& best_action() const;
+};
+
+// Single-observer information set Monte Carlo tree search. The hands of the other players are unknown to the player
+// whose turn it is, so every iteration first samples them from the public information (see
+// CardsState::sample_determinization()) and then descends the tree with UCT. Only the children whose actions are
+// legal in the sampled game are considered, their exploration term is based on how often they were available.
+//
+// With several threads, all workers share one tree (tree parallelism). Node statistics are atomic counters, children
+// are prepended to a lock-free singly linked list and nodes are taken from a pool by bumping an atomic index, so no locks
+// are needed. The pool is allocated chunk by chunk, the worker that first takes a node of a chunk installs it with a
+// compare-and-swap. Virtual losses spread the workers over different paths.
+class Ismcts {
+	public:
+		explicit Ismcts(const IsmctsConfig& config);
+
+		~Ismcts();
+
+		IsmctsResult search(const DogGame& game);
+
+	private:
+		class Node {
+			public:
+				ActionVar action = Give(None);
+				// Player that played the action leading to this node
+				int player = -1;
+				std::atomic<uint64_t> visits;
+				std::atomic<uint64_t> availability;
+				std::atomic<uint64_t> virtual_losses;
+				// Sum of the rewards for the team of the player in half points (2 for a win, 1 for a draw), so that
+				// it can be updated atomically
+				std::atomic<uint64_t> reward;
+				// Head of the list of children, ISMCTS_NO_NODE if there are none
+				std::atomic<uint32_t> first_child;
+				// Only written before the node is added to the list of its parent
+				uint32_t next_sibling;
+
+				// Called by the worker that allocated the node before any other worker can see it
+				void init(const ActionVar& action, int player);
+		};
+
+		// State owned by a single worker thread
+		class Worker {
+			public:
+				Rng rng;
+				Playout playout;
+
+				// Buffers reused by all iterations
+				DogGame determinization;
+				ActionBuffer actions;
+				std::vector<uint32_t> path;
+				std::vector<uint32_t> available;
+				std::vector<uint32_t> untried;
+
+				Worker(const IsmctsConfig& config, uint64_t seed);
+		};
+
+		IsmctsConfig config;
+		std::vector<Worker> workers;
+
+		// Chunks of the node pool, a chunk is set once and stays allocated for later searches
+		std::unique_ptr<std::atomic<Node*>[]> chunks;
+		uint32_t chunk_count;
+		// Number of nodes the current search may use
+		uint32_t node_capacity = 0;
+		std::atomic<uint32_t> node_count;
+
+		Node& get_node(uint32_t idx) {
+			return chunks[idx >> ISMCTS_NODE_CHUNK_BITS].load(std::memory_order_acquire)[idx & (ISMCTS_NODE_CHUNK_SIZE - 1)];
+		}
+
+		// Allocates the chunk of the node unless that already happened
+		void ensure_chunk(uint32_t idx);
+
+		void iterate(Worker& worker, const DogGame& game, int observer);
+
+		uint32_t select_child(const Worker& worker);
+
+		// Returns ISMCTS_NO_NODE if the pool is exhausted
+		uint32_t expand(Worker& worker, uint32_t parent, int player);
+
+		void enter(Worker& worker, uint32_t node);
+
+		void backpropagate(Worker& worker, int winner);
+};
+
+}
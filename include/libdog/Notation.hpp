@@ -1,6 +1,7 @@
 #pragma once
 
 #include <optional>
+#include <string_view>
 
 #include "Action.hpp"
 #include "BoardState.hpp"
@@ -15,11 +16,12 @@ class BoardState;
 
 ActionVar from_notation(int player, string notation_str);
 
-BoardState from_notation(string notation_str);
+BoardState from_notation(std::string_view notation_str);
 
 optional<ActionVar> try_parse_notation(int player, string notation_str);
 
-optional<BoardState> try_parse_notation(string notation_str);
+// Parses a board without allocating, whitespace is ignored
+optional<BoardState> try_parse_notation(std::string_view notation_str);
 
 string to_notation(int player, ActionVar action);
 
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <variant>
+
+#include "DogGame.hpp"
+#include "Action.hpp"
+
+
+namespace libdog {
+
+#define ACTION_TYPE_COUNT (std::variant_size_v<ActionVar>)
+
+class PerftResult {
+	public:
+		uint64_t nodes = 0;
+
+		// Number of leaf nodes per type of the action that lead to them
+		// Indexed the same way as the alternatives of ActionVar (Give, Discard, Start, Move, MoveMultiple, Swap)
+		std::array<uint64_t, ACTION_TYPE_COUNT> action_type_counts = {};
+
+		PerftResult& operator+=(const PerftResult& other);
+
+		friend bool operator==(const PerftResult& a, const PerftResult& b) = default;
+};
+
+std::string get_action_type_name(std::size_t action_type);
+
+// Counts the leaf nodes of the game tree of the given depth by recursively playing all possible actions of the player
+// whose turn it is. A node in which the game is over has no children. The game is left unchanged.
+PerftResult perft(DogGame& game, int depth);
+
+}
@@ -11,8 +11,8 @@ namespace libdog {
 
 class Piece {
 	public:
-		const int player;
-		const int idx;
+		int player;
+		int idx;
 		BoardPosition position;
 		bool blocking;
 
@@ -27,16 +27,9 @@ class Piece {
 		explicit Piece(int player, int idx) : Piece(player, idx, BoardPosition(0)) {
 		}
 
-		Piece(const Piece& other) : Piece(other.player, other.idx, other.position, other.blocking) {
-		}
-
-		Piece& operator=(const Piece& other) {
-			if (this != &other) {
-				position = other.position;
-				blocking = other.blocking;
-			}
-
-			return *this;
+		// Identifies the piece among all pieces on the board
+		int get_id() const {
+			return player * PIECE_COUNT + idx;
 		}
 
 		friend bool operator==(const Piece& a, const Piece& b) {
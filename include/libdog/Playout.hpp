@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+#include "DogGame.hpp"
+#include "ActionBuffer.hpp"
+#include "Rng.hpp"
+
+
+namespace libdog {
+
+// Progress of the pieces of team 0 minus the progress of the pieces of team 1, see BoardFeatures::progress
+int evaluate_progress(const BoardState& board_state);
+
+// Selects one of the possible actions of the player whose turn it is by returning its index. The actions are never
+// empty. The game may be modified temporarily, but has to be restored before returning.
+using PlayoutPolicy = std::size_t (*)(DogGame& game, const ActionBuffer& actions, Rng& rng);
+
+// Selects every action with the same probability
+std::size_t uniform_random_policy(DogGame& game, const ActionBuffer& actions, Rng& rng);
+
+// Selects the action after which the pieces of the own team are furthest ahead of the pieces of the other team, ties
+// are broken randomly
+std::size_t greedy_policy(DogGame& game, const ActionBuffer& actions, Rng& rng);
+
+class PlayoutResult {
+	public:
+		// Team that won the game, -1 if the move limit was reached before
+		int winner = -1;
+		int move_count = 0;
+		// Sum of the number of possible actions over all moves
+		uint64_t action_count = 0;
+};
+
+// Plays games to their end with a policy. The engine owns the game it plays on as well as the action buffer, so that
+// repeated playouts do not allocate once the buffers have grown to their working size.
+class Playout {
+	public:
+		// A max_moves of 0 means that games are always played until one of the teams wins
+		explicit Playout(PlayoutPolicy policy = uniform_random_policy, uint64_t seed = 0, int max_moves = 0);
+
+		// Plays a copy of the game to its end, the game itself is left unchanged
+		PlayoutResult run(const DogGame& start);
+
+		Rng& get_rng() {
+			return rng;
+		}
+
+	private:
+		PlayoutPolicy policy;
+		Rng rng;
+		int max_moves;
+
+		DogGame game;
+		ActionBuffer actions;
+};
+
+}
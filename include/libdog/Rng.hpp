@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+
+namespace libdog {
+
+constexpr uint64_t splitmix64(uint64_t& state) {
+	uint64_t z = (state += UINT64_C(0x9E3779B97F4A7C15));
+	z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+	return z ^ (z >> 31);
+}
+
+// xoshiro256** generator. The whole state is four words, so it is cheap to copy along with a game. Satisfies the
+// requirements of UniformRandomBitGenerator and can be used with the standard library distributions and algorithms.
+class Rng {
+	private:
+		std::array<uint64_t, 4> state;
+
+		static constexpr uint64_t rotl(uint64_t x, int k) {
+			return (x << k) | (x >> (64 - k));
+		}
+
+	public:
+		using result_type = uint64_t;
+
+		explicit Rng(uint64_t seed = 0) {
+			seed_with(seed);
+		}
+
+		// The state is expanded from the seed with splitmix64, which never yields an all-zero state
+		void seed_with(uint64_t seed) {
+			for (uint64_t& word : state) {
+				word = splitmix64(seed);
+			}
+		}
+
+		// The state can be stored and restored to continue the sequence exactly where it was
+		std::array<uint64_t, 4> get_state() const {
+			return state;
+		}
+
+		void set_state(const std::array<uint64_t, 4>& new_state) {
+			state = new_state;
+		}
+
+		static constexpr uint64_t min() {
+			return 0;
+		}
+
+		static constexpr uint64_t max() {
+			return std::numeric_limits<uint64_t>::max();
+		}
+
+		uint64_t operator()() {
+			uint64_t result = rotl(state[1] * 5, 7) * 9;
+			uint64_t t = state[1] << 17;
+
+			state[2] ^= state[0];
+			state[3] ^= state[1];
+			state[1] ^= state[2];
+			state[0] ^= state[3];
+			state[2] ^= t;
+			state[3] = rotl(state[3], 45);
+
+			return result;
+		}
+
+		// Uniformly distributed number in [0, bound), bound must not be zero. Uses the multiply-shift reduction, the
+		// bias is negligible for the small bounds this is used for.
+		uint32_t below(uint32_t bound) {
+			return static_cast<uint32_t>(((*this)() >> 32) * bound >> 32);
+		}
+
+		friend bool operator==(const Rng& a, const Rng& b) {
+			return a.state == b.state;
+		}
+};
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "DogGame.hpp"
+#include "Action.hpp"
+#include "ActionBuffer.hpp"
+#include "BoardState.hpp"
+#include "Playout.hpp"
+#include "TranspositionTable.hpp"
+
+
+// Value of a won game, evaluations have to stay below it
+#define SOLVER_WIN_VALUE (1 << 20)
+
+namespace libdog {
+
+// Evaluates a board from the perspective of team 0, larger is better
+using BoardEvaluation = int (*)(const BoardState& board_state);
+
+class RoundSolverConfig {
+	public:
+		BoardEvaluation evaluation = evaluate_progress;
+		// The search stops after this many actions even if the round is not over yet, 0 means no limit
+		int max_depth = 0;
+		// Size of the transposition table the solver allocates, 0 disables it
+		std::size_t table_size = 16 << 20;
+		// If set, this table is used instead. It can be shared by solvers on several threads as long as they use the
+		// same evaluation.
+		TranspositionTable* table = nullptr;
+};
+
+class RoundSolverResult {
+	public:
+		// Value for the team of the player whose turn it was, SOLVER_WIN_VALUE if the team wins within the round
+		int value = 0;
+		// Actions of all players until the end of the round (or the depth limit) if everyone plays optimally
+		std::vector<ActionVar> line;
+		uint64_t nodes = 0;
+};
+
+// Searches the remainder of the current round with alpha-beta assuming that all hands are known (double dummy). The
+// round ends when the last hand card is played, the board is evaluated at that point. Gives are searched like any other
+// action.
+//
+// Positions are identified by DogGame::hash(), so positions that are reached by different orders of actions (e.g. the
+// splits of a seven) are searched only once. Actions are tried in the order of the static evaluation after playing
+// them, the best action of a previous search of the position comes first.
+class RoundSolver {
+	public:
+		explicit RoundSolver(const RoundSolverConfig& config = RoundSolverConfig());
+
+		// The game is left unchanged
+		RoundSolverResult solve(DogGame& game);
+
+	private:
+		RoundSolverConfig config;
+		std::unique_ptr<TranspositionTable> own_table;
+		TranspositionTable* table;
+
+		uint64_t nodes = 0;
+
+		class OrderedAction {
+			public:
+				// Actions with higher priority are searched first
+				int priority;
+				// Static value of the position after the action, final if the action is a leaf
+				int value;
+				bool is_leaf;
+				uint32_t idx;
+		};
+
+		// One action list per ply, the actions are searched in the order given by the ordered actions
+		std::vector<ActionBuffer> actions;
+		std::vector<std::vector<OrderedAction>> orders;
+
+		// Number of actions until the end of the round
+		static int get_remaining_actions(DogGame& game);
+
+		// Value from the perspective of the team of the player whose turn it is. best_idx receives the index of the
+		// best action in the action list of the ply.
+		int search(DogGame& game, int depth, int ply, int alpha, int beta, int& best_idx);
+
+		// Evaluates the position after playing the action and returns the value for the team of the player that
+		// played it. is_leaf is set if the game or the round ended with the action.
+		int evaluate_action(DogGame& game, const UndoRecord& record, int team, bool& is_leaf);
+};
+
+}
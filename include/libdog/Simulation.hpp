@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Playout.hpp"
+
+
+namespace libdog {
+
+class SimulationConfig {
+	public:
+		uint64_t game_count = 1000;
+		// Every game is derived from this seed and its index, so the results do not depend on the number of threads
+		uint64_t seed = 0;
+		// 0 means one thread per hardware thread
+		unsigned thread_count = 0;
+		PlayoutPolicy policy = uniform_random_policy;
+		// 0 means that every game is played until one of the teams wins
+		int max_moves = 0;
+};
+
+class SimulationStats {
+	public:
+		uint64_t game_count = 0;
+		// Wins per team, games that hit the move limit are not counted
+		std::array<uint64_t, 2> wins = {};
+		uint64_t move_count = 0;
+		uint64_t action_count = 0;
+		int min_game_length = 0;
+		int max_game_length = 0;
+
+		void add(const PlayoutResult& result);
+
+		SimulationStats& operator+=(const SimulationStats& other);
+
+		friend bool operator==(const SimulationStats& a, const SimulationStats& b) = default;
+
+		double get_win_rate(int team) const;
+
+		double get_mean_game_length() const;
+
+		// Mean number of possible actions a player could choose from
+		double get_mean_actions_per_move() const;
+};
+
+// Seed of the game with the given index
+uint64_t get_game_seed(uint64_t seed, uint64_t game_idx);
+
+// Plays complete games from the initial position on a pool of threads. Each worker owns its game and playout engine.
+SimulationStats simulate(const SimulationConfig& config);
+
+}
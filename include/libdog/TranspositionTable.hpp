@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+#define TT_BUCKET_SIZE (4)
+
+namespace libdog {
+
+enum TranspositionBound {
+	BoundExact = 1,
+	// The value is at least the stored one
+	BoundLower = 2,
+	// The value is at most the stored one
+	BoundUpper = 3,
+};
+
+class TranspositionEntry {
+	public:
+		int32_t value = 0;
+		int8_t depth = 0;
+		TranspositionBound bound = BoundExact;
+		// Index of the best action in the list of possible actions of the position, -1 if unknown
+		int16_t best_action = -1;
+
+		friend bool operator==(const TranspositionEntry& a, const TranspositionEntry& b) = default;
+};
+
+// Fixed-size hash table of search results that can be shared by several threads without locks. Keys are full game
+// hashes (see DogGame::hash()).
+//
+// Every slot holds the entry packed into one word and the key xored with that word, each in an atomic. A reader only
+// accepts a slot if both words belong to the same store, so concurrent stores into the same slot can lose an entry
+// but never return a mixture of two entries.
+class TranspositionTable {
+	private:
+		class Slot {
+			public:
+				std::atomic<uint64_t> check = 0;
+				// 0 means that the slot is empty, a stored entry is never 0 since its bound is not 0
+				std::atomic<uint64_t> data = 0;
+		};
+
+		// One bucket per cache line
+		class alignas(64) Bucket {
+			public:
+				std::array<Slot, TT_BUCKET_SIZE> slots;
+		};
+
+		std::vector<Bucket> buckets;
+		uint64_t mask;
+
+		static uint64_t pack(const TranspositionEntry& entry);
+
+		static TranspositionEntry unpack(uint64_t data);
+
+		Bucket& get_bucket(uint64_t key) {
+			return buckets[key & mask];
+		}
+
+		const Bucket& get_bucket(uint64_t key) const {
+			return buckets[key & mask];
+		}
+
+	public:
+		// The number of buckets is the largest power of two that fits into the given size, but at least one
+		explicit TranspositionTable(std::size_t size_bytes);
+
+		// Returns false if there is no entry for the key
+		bool probe(uint64_t key, TranspositionEntry& result) const;
+
+		// Overwrites the entry of the same key if there is one. Otherwise an empty slot of the bucket is used or the
+		// one with the lowest depth is replaced.
+		void store(uint64_t key, const TranspositionEntry& entry);
+
+		// Must not be called while other threads access the table
+		void clear();
+
+		// Number of entries the table can hold
+		std::size_t get_capacity() const {
+			return buckets.size() * TT_BUCKET_SIZE;
+		}
+};
+
+}
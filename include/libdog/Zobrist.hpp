@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Area.hpp"
+#include "BoardPosition.hpp"
+#include "Card.hpp"
+#include "Constants.hpp"
+#include "Rng.hpp"
+
+
+// Path positions come first, followed by the finish positions of each player. Pieces in the kennel do not contribute
+// to the hash, their number is implied by the other positions.
+#define ZOBRIST_CELL_COUNT (PATH_LENGTH + PLAYER_COUNT * FINISH_LENGTH)
+#define ZOBRIST_NO_CELL (-1)
+// Card keys are indexed by the value of the card
+#define ZOBRIST_CARD_COUNT (Joker + 1)
+
+namespace libdog {
+
+// Random keys for every (player, cell) pair. Since pieces of the same player are interchangeable, the key only
+// depends on the owner of a piece and not on the piece itself. At most one piece per player can be blocking (the one
+// on its start), so a single blocking key per player suffices.
+//
+// Cards are hashed as multisets: the keys of all cards in a stack are added up, which does not depend on the order of
+// the cards and still distinguishes several cards of the same kind.
+class ZobristKeys {
+	public:
+		std::array<std::array<uint64_t, ZOBRIST_CELL_COUNT>, PLAYER_COUNT> cells = {};
+		std::array<uint64_t, PLAYER_COUNT> blocking = {};
+
+		std::array<std::array<uint64_t, ZOBRIST_CARD_COUNT>, PLAYER_COUNT> hand_cards = {};
+		std::array<std::array<uint64_t, ZOBRIST_CARD_COUNT>, PLAYER_COUNT> give_buffer_cards = {};
+		// Added once per card in the deck
+		uint64_t deck_card = 0;
+		std::array<uint64_t, PLAYER_COUNT> player_turn = {};
+		uint64_t give_phase_done = 0;
+		// Indexed by the size of the next handout
+		std::array<uint64_t, STARTING_HANDOUT_SIZE + 1> next_hand_size = {};
+
+		constexpr ZobristKeys() {
+			uint64_t state = 0;
+
+			for (int player = 0; player < PLAYER_COUNT; player++) {
+				for (int cell = 0; cell < ZOBRIST_CELL_COUNT; cell++) {
+					cells[player][cell] = splitmix64(state);
+				}
+
+				blocking[player] = splitmix64(state);
+			}
+
+			for (int player = 0; player < PLAYER_COUNT; player++) {
+				for (int card = 0; card < ZOBRIST_CARD_COUNT; card++) {
+					hand_cards[player][card] = splitmix64(state);
+					give_buffer_cards[player][card] = splitmix64(state);
+				}
+
+				player_turn[player] = splitmix64(state);
+			}
+
+			deck_card = splitmix64(state);
+			give_phase_done = splitmix64(state);
+
+			for (uint64_t& key : next_hand_size) {
+				key = splitmix64(state);
+			}
+		}
+};
+
+inline constexpr ZobristKeys zobrist_keys;
+
+inline int get_zobrist_finish_cell(int player, int finish_idx) {
+	return PATH_LENGTH + player * FINISH_LENGTH + finish_idx;
+}
+
+inline int get_zobrist_cell(const BoardPosition& position) {
+	switch (position.area) {
+		case Path:
+			return position.idx;
+		case Finish:
+			return get_zobrist_finish_cell(position.player, position.idx);
+		default:
+			return ZOBRIST_NO_CELL;
+	}
+}
+
+inline uint64_t get_zobrist_key(int player, const BoardPosition& position, bool blocking) {
+	int cell = get_zobrist_cell(position);
+
+	if (cell == ZOBRIST_NO_CELL) {
+		return 0;
+	}
+
+	uint64_t key = zobrist_keys.cells[player][cell];
+
+	if (blocking) {
+		key ^= zobrist_keys.blocking[player];
+	}
+
+	return key;
+}
+
+}
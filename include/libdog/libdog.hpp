@@ -1,12 +1,24 @@
 #include <libdog/Action.hpp>
+#include <libdog/ActionBuffer.hpp>
 #include <libdog/Area.hpp>
 #include <libdog/BoardPosition.hpp>
 #include <libdog/BoardState.hpp>
+#include <libdog/BoundedVector.hpp>
 #include <libdog/Card.hpp>
+#include <libdog/CardHand.hpp>
 #include <libdog/CardsState.hpp>
 #include <libdog/CardStack.hpp>
 #include <libdog/Constants.hpp>
 #include <libdog/DogGame.hpp>
+#include <libdog/FinishTablebase.hpp>
+#include <libdog/Ismcts.hpp>
 #include <libdog/Notation.hpp>
+#include <libdog/Perft.hpp>
 #include <libdog/Piece.hpp>
 #include <libdog/PieceRef.hpp>
+#include <libdog/Playout.hpp>
+#include <libdog/Rng.hpp>
+#include <libdog/RoundSolver.hpp>
+#include <libdog/Simulation.hpp>
+#include <libdog/TranspositionTable.hpp>
+#include <libdog/Zobrist.hpp>
@@ -1,69 +1,55 @@
 #include <libdog/BoardState.hpp>
 
+#include <numeric>
+#include <bit>
+#include <stdexcept>
+
 #include "Util.hpp"
 #include "Debug.hpp"
 
 
 namespace libdog {
 
-BoardState::BoardState() : pieces{{
-		{{ Piece(0, 0, BoardPosition(Kennel, 0, 0), false), Piece(0, 1, BoardPosition(Kennel, 0, 1), false), Piece(0, 2, BoardPosition(Kennel, 0, 2), false), Piece(0, 3, BoardPosition(Kennel, 0, 3), false) }},
-		{{ Piece(1, 0, BoardPosition(Kennel, 1, 0), false), Piece(1, 1, BoardPosition(Kennel, 1, 1), false), Piece(1, 2, BoardPosition(Kennel, 1, 2), false), Piece(1, 3, BoardPosition(Kennel, 1, 3), false) }},
-		{{ Piece(2, 0, BoardPosition(Kennel, 2, 0), false), Piece(2, 1, BoardPosition(Kennel, 2, 1), false), Piece(2, 2, BoardPosition(Kennel, 2, 2), false), Piece(2, 3, BoardPosition(Kennel, 2, 3), false) }},
-		{{ Piece(3, 0, BoardPosition(Kennel, 3, 0), false), Piece(3, 1, BoardPosition(Kennel, 3, 1), false), Piece(3, 2, BoardPosition(Kennel, 3, 2), false), Piece(3, 3, BoardPosition(Kennel, 3, 3), false) }}
-	}} {
-	one_step_undo_stack.reserve(8);
-	reset();
-}
-
-BoardState::BoardState(const BoardState& other) : pieces(other.pieces), one_step_undo_stack(other.one_step_undo_stack), undo_stack_activated(other.undo_stack_activated) {
-	assert(other.check_state());
-
-	path.fill(nullptr);
-
-	for (int player = 0; player < PLAYER_COUNT; player++) {
-		kennels[player].fill(nullptr);
-		finishes[player].fill(nullptr);
-
-		for (int i = 0; i < PIECE_COUNT; i++) {
-			PiecePtr piece_ptr = &pieces[player][i];
-
-			get_piece(piece_ptr->position) = piece_ptr;
-		}
+// Path and finish positions are encoded like Zobrist cells, kennel positions follow after them
+static int8_t encode_position(const BoardPosition& position) {
+	if (position.area == Kennel) {
+		return ZOBRIST_CELL_COUNT + position.player * KENNEL_SIZE + position.idx;
 	}
 
-	assert(check_state());
+	return get_zobrist_cell(position);
 }
 
-BoardState& BoardState::operator=(const BoardState& other) {
-	assert(other.check_state());
-
-	if (this != &other) {
-		pieces = other.pieces;
-		one_step_undo_stack = other.one_step_undo_stack;
-		undo_stack_activated = other.undo_stack_activated;
-
-		path.fill(nullptr);
-
-		for (int player = 0; player < PLAYER_COUNT; player++) {
-			kennels[player].fill(nullptr);
-			finishes[player].fill(nullptr);
-
-			for (int i = 0; i < PIECE_COUNT; i++) {
-				PiecePtr piece_ptr = &pieces[player][i];
+static BoardPosition decode_position(int code) {
+	if (code < PATH_LENGTH) {
+		return BoardPosition(code);
+	}
 
-				get_piece(piece_ptr->position) = piece_ptr;
-			}
-		}
+	if (code < ZOBRIST_CELL_COUNT) {
+		code -= PATH_LENGTH;
+		return BoardPosition(Finish, code / FINISH_LENGTH, code % FINISH_LENGTH);
 	}
 
-	return *this;
+	code -= ZOBRIST_CELL_COUNT;
+	return BoardPosition(Kennel, code / KENNEL_SIZE, code % KENNEL_SIZE);
+}
+
+BoardState::BoardState() : pieces{{
+		{{ Piece(0, 0, BoardPosition(Kennel, 0, 0), false), Piece(0, 1, BoardPosition(Kennel, 0, 1), false), Piece(0, 2, BoardPosition(Kennel, 0, 2), false), Piece(0, 3, BoardPosition(Kennel, 0, 3), false) }},
+		{{ Piece(1, 0, BoardPosition(Kennel, 1, 0), false), Piece(1, 1, BoardPosition(Kennel, 1, 1), false), Piece(1, 2, BoardPosition(Kennel, 1, 2), false), Piece(1, 3, BoardPosition(Kennel, 1, 3), false) }},
+		{{ Piece(2, 0, BoardPosition(Kennel, 2, 0), false), Piece(2, 1, BoardPosition(Kennel, 2, 1), false), Piece(2, 2, BoardPosition(Kennel, 2, 2), false), Piece(2, 3, BoardPosition(Kennel, 2, 3), false) }},
+		{{ Piece(3, 0, BoardPosition(Kennel, 3, 0), false), Piece(3, 1, BoardPosition(Kennel, 3, 1), false), Piece(3, 2, BoardPosition(Kennel, 3, 2), false), Piece(3, 3, BoardPosition(Kennel, 3, 3), false) }}
+	}} {
+	reset();
 }
 
 bool operator==(const BoardState& a, const BoardState& b) {
 	assert(a.check_state());
 	assert(b.check_state());
 
+	if (a.hash() != b.hash()) {
+		return false;
+	}
+
 	for (int player = 0; player < PLAYER_COUNT; player++) {
 		for (int i = 0; i < PIECE_COUNT; i++) {
 			const Piece* piece_ptr = &a.pieces[player][i];
@@ -90,7 +76,7 @@ void BoardState::reset() {
 		for (std::size_t j = 0; j != kennels.size(); j++) {
 			Piece* piece = &pieces[player][j];
 
-			kennels[player][j] = piece;
+			kennels[player][j] = piece->get_id();
 
 			piece->position = BoardPosition(Kennel, player, j);
 			piece->blocking = false;
@@ -98,44 +84,227 @@ void BoardState::reset() {
 	}
 
 	for (std::size_t player = 0; player != finishes.size(); player++) {
-		finishes[player].fill(nullptr);
+		finishes[player].fill(NO_PIECE);
 	}
 
-	path.fill(nullptr);
-	one_step_undo_stack.clear();
-	undo_stack_activated = false;
+	path.fill(NO_PIECE);
+	journal = nullptr;
+	journal_depth = 0;
+
+	// Pieces in the kennel do not contribute to the hash
+	zobrist_hash = 0;
+
+	reset_occupancy();
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		std::iota(rank_order[player].begin(), rank_order[player].end(), 0);
+
+		for (int idx = 0; idx < PIECE_COUNT; idx++) {
+			update_rank(pieces[player][idx]);
+		}
+	}
 }
 
-PiecePtr BoardState::ref_to_piece(const PieceRef& piece_ref) const {
-	int player = piece_ref.player;
-	int rank = piece_ref.rank;
+// Orders the pieces of a player in the same way as Piece::is_behind(), pieces with larger progress have lower ranks.
+// Unlike is_behind() this does not assert on blocking pieces outside of the start, which notation strings allow.
+static int get_rank_progress(const Piece& piece) {
+	switch (piece.position.area) {
+		case Kennel:
+			return KENNEL_SIZE - 1 - piece.position.idx;
+		case Path: {
+			int steps_to_start = calc_steps_to_start(piece.player, piece.position.idx);
 
-	std::vector<PiecePtr> pieces_ordered;
-	pieces_ordered.reserve(PIECE_COUNT);
+			if (piece.blocking && steps_to_start == 0) {
+				steps_to_start = PATH_LENGTH;
+			}
 
-	for (std::size_t i = 0; i < PLAYER_COUNT; i++) {
-		PiecePtr to_insert = const_cast<PiecePtr>(&pieces[player][i]);
+			return KENNEL_SIZE + PATH_LENGTH - steps_to_start;
+		}
+		case Finish:
+			return KENNEL_SIZE + PATH_LENGTH + 1 + piece.position.idx;
+		default:
+			assert(false);
+			return 0;
+	}
+}
 
-		std::size_t insert_idx = 0;
+void BoardState::update_rank(const Piece& piece) {
+	int player = piece.player;
+	std::array<int, PIECE_COUNT>& order = rank_order[player];
+	std::array<int, PIECE_COUNT>& progress = rank_progress[player];
 
-		for (; insert_idx < pieces_ordered.size(); insert_idx++) {
-			PiecePtr piece_ptr = pieces_ordered[insert_idx];
-			assert(piece_ptr != nullptr);
-			if (piece_ptr->is_behind(*to_insert)) {
-				break;
+	progress[piece.idx] = get_rank_progress(piece);
+
+	// Only the changed pieces are out of place, insertion sort is cheap on the nearly ordered array
+	for (int i = 1; i < PIECE_COUNT; i++) {
+		int piece_idx = order[i];
+		int j = i;
+
+		for (; j > 0 && progress[order[j - 1]] < progress[piece_idx]; j--) {
+			order[j] = order[j - 1];
+		}
+
+		order[j] = piece_idx;
+	}
+}
+
+void BoardState::toggle_occupancy(const Piece& piece) {
+	const BoardPosition& position = piece.position;
+
+	switch (position.area) {
+		case Path:
+			path_masks[piece.player] ^= UINT64_C(1) << position.idx;
+
+			if (piece.blocking) {
+				blocking_mask ^= UINT64_C(1) << position.idx;
 			}
+			break;
+		case Finish:
+			finish_masks[position.player] ^= 1 << position.idx;
+			break;
+		case Kennel:
+			kennel_masks[position.player] ^= 1 << position.idx;
+			break;
+		default:
+			assert(false);
+	}
+}
+
+void BoardState::reset_occupancy() {
+	path_masks.fill(0);
+	finish_masks.fill(0);
+	kennel_masks.fill(0);
+	blocking_mask = 0;
+	piece_features = BoardFeatures();
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		for (int idx = 0; idx < PIECE_COUNT; idx++) {
+			toggle_occupancy(pieces[player][idx]);
+			update_features(pieces[player][idx], 1);
 		}
+	}
+}
 
-		pieces_ordered.insert(pieces_ordered.begin() + insert_idx, to_insert);
+// Same as calc_steps_to_start(), but a blocking piece has to go around the whole path. Like get_rank_progress(), this
+// does not assert on blocking pieces outside of the start.
+static int get_steps_to_start(const Piece& piece) {
+	int steps_to_start = calc_steps_to_start(piece.player, piece.position.idx);
+
+	if (piece.blocking && steps_to_start == 0) {
+		steps_to_start = PATH_LENGTH;
+	}
+
+	return steps_to_start;
+}
+
+void BoardState::update_features(const Piece& piece, int sign) {
+	int player = piece.player;
+
+	switch (piece.position.area) {
+		case Kennel:
+			piece_features.kennel_count[player] += sign;
+			break;
+		case Path: {
+			int steps_to_start = get_steps_to_start(piece);
+			piece_features.distance_to_finish[player] += sign * steps_to_start;
+			piece_features.progress[player] += sign * (PATH_LENGTH - steps_to_start);
+
+			if (piece.blocking) {
+				piece_features.blocking_count[player] += sign;
+			}
+			break;
+		}
+		case Finish:
+			piece_features.finish_count[player] += sign;
+			piece_features.progress[player] += sign * (PATH_LENGTH + 1 + piece.position.idx);
+			break;
+		default:
+			assert(false);
+	}
+}
+
+static uint64_t rotate_path_mask(uint64_t mask, int steps) {
+	static_assert(PATH_LENGTH == 64);
+	return std::rotl(mask, steps);
+}
+
+BoardFeatures BoardState::features() const {
+	BoardFeatures result = piece_features;
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		uint64_t opponents = path_masks[(player + 1) % PLAYER_COUNT] | path_masks[(player + 3) % PLAYER_COUNT];
+		uint64_t reach = rotate_path_mask(opponents, -STRIKING_RANGE_BACKWARD);
+
+		for (int steps = 1; steps <= STRIKING_RANGE_FORWARD; steps++) {
+			reach |= rotate_path_mask(opponents, steps);
+		}
+
+		result.threatened_count[player] = std::popcount(path_masks[player] & ~blocking_mask & reach);
 	}
 
-	PiecePtr result = pieces_ordered[rank];
 	return result;
 }
 
-PiecePtr& BoardState::ref_to_piece_ptr_ref(const PieceRef& piece_ref) {
-	PiecePtr piece_ptr = ref_to_piece(piece_ref);
-	return get_piece(piece_ptr->position);
+BoardFeatures BoardState::compute_features() const {
+	BoardFeatures result;
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		for (const Piece& piece : pieces[player]) {
+			switch (piece.position.area) {
+				case Kennel:
+					result.kennel_count[player]++;
+					break;
+				case Path:
+					result.distance_to_finish[player] += get_steps_to_start(piece);
+					result.progress[player] += PATH_LENGTH - get_steps_to_start(piece);
+					result.blocking_count[player] += piece.blocking;
+					break;
+				case Finish:
+					result.finish_count[player]++;
+					result.progress[player] += PATH_LENGTH + 1 + piece.position.idx;
+					break;
+				default:
+					assert(false);
+			}
+		}
+	}
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		for (const Piece& piece : pieces[player]) {
+			if (piece.position.area != Path || piece.blocking) {
+				continue;
+			}
+
+			bool threatened = false;
+
+			for (int other = 0; other < PLAYER_COUNT; other++) {
+				if (other % 2 == player % 2) {
+					continue;
+				}
+
+				for (const Piece& opponent_piece : pieces[other]) {
+					if (opponent_piece.position.area != Path) {
+						continue;
+					}
+
+					int distance = (piece.position.idx - opponent_piece.position.idx + PATH_LENGTH) % PATH_LENGTH;
+
+					if ((1 <= distance && distance <= STRIKING_RANGE_FORWARD) || distance == PATH_LENGTH - STRIKING_RANGE_BACKWARD) {
+						threatened = true;
+					}
+				}
+			}
+
+			result.threatened_count[player] += threatened;
+		}
+	}
+
+	return result;
+}
+
+PiecePtr BoardState::ref_to_piece(const PieceRef& piece_ref) const {
+	int piece_idx = rank_order[piece_ref.player][piece_ref.rank];
+	return const_cast<PiecePtr>(&pieces[piece_ref.player][piece_idx]);
 }
 
 BoardPosition BoardState::ref_to_pos(const PieceRef& piece_ref) const {
@@ -143,14 +312,20 @@ BoardPosition BoardState::ref_to_pos(const PieceRef& piece_ref) const {
 	return piece_ptr->position;
 }
 
-bool BoardState::get_kennel_piece(int player, PiecePtr** result) {
+PiecePtr BoardState::id_to_piece(int piece_id) const {
+	if (piece_id == NO_PIECE) {
+		return nullptr;
+	}
+
+	return const_cast<PiecePtr>(&pieces[piece_id / PIECE_COUNT][piece_id % PIECE_COUNT]);
+}
+
+bool BoardState::get_kennel_piece(int player, PiecePtr& result) {
 	auto& kennel = kennels.at(player);
 
 	for (std::size_t i = 0; i < kennel.size(); i++) {
-		PiecePtr* piece = &(kennel.at(i));
-
-		if (*piece != nullptr) {
-			*result = piece;
+		if (kennel.at(i) != NO_PIECE) {
+			result = id_to_piece(kennel.at(i));
 			return true;
 		}
 	}
@@ -158,7 +333,7 @@ bool BoardState::get_kennel_piece(int player, PiecePtr** result) {
 	return false;
 }
 
-void BoardState::start_piece(PiecePtr& piece) {
+void BoardState::start_piece(PiecePtr piece) {
 	assert(piece->position.area == Kennel);
 
 	int start_path_idx = get_start_path_idx(piece->player);
@@ -166,12 +341,15 @@ void BoardState::start_piece(PiecePtr& piece) {
 	move_piece(piece, start_position, true);
 }
 
-PiecePtr& BoardState::get_piece(int path_idx) {
-	return path.at(path_idx);
+PiecePtr BoardState::get_piece(int path_idx) const {
+	return id_to_piece(path.at(path_idx));
+}
+
+PiecePtr BoardState::get_piece(BoardPosition position) const {
+	return id_to_piece(get_slot(position));
 }
 
-// TODO Optimization: get_piece can be replaced by a pointer in the piece object to its slot
-const PiecePtr& BoardState::get_piece(BoardPosition position) const {
+const PieceId& BoardState::get_slot(const BoardPosition& position) const {
 	switch(position.area) {
 		case Path:
 			return path.at(position.idx);
@@ -184,44 +362,60 @@ const PiecePtr& BoardState::get_piece(BoardPosition position) const {
 	}
 }
 
-PiecePtr& BoardState::get_piece(BoardPosition position) {
-	return const_cast<PiecePtr&>(static_cast<const BoardState&>(*this).get_piece(position));
+PieceId& BoardState::get_slot(const BoardPosition& position) {
+	return const_cast<PieceId&>(static_cast<const BoardState&>(*this).get_slot(position));
 }
 
-PiecePtr& BoardState::get_start(int player) {
+PiecePtr BoardState::get_start(int player) const {
 	int start_path_idx = get_start_path_idx(player);
-	PiecePtr& piece = get_piece(BoardPosition(start_path_idx));
-	return piece;
+	return get_piece(start_path_idx);
 }
 
 void BoardState::send_to_kennel(int from_path_idx, int count) {
 	bool backwards = (count < 0);
-	int step = backwards ? -1 : 1;
+	int steps = backwards ? -count : count;
 
-	for (int i = 0; i != count; i += step) {
-		int path_idx = positive_mod(from_path_idx + step + i, PATH_LENGTH);
+	if (steps == 0) {
+		return;
+	}
 
-		if (path_idx == from_path_idx) {
-			continue;
-		}
+	assert(steps < PATH_LENGTH);
 
-		PiecePtr& piece = get_piece(BoardPosition(path_idx));
+	// Occupied positions on the way, rotated such that bit k corresponds to the position k + 1 steps away
+	uint64_t occupied = get_path_mask();
+	uint64_t way;
 
-		if (piece != nullptr) {
-			assert(!piece->blocking);
-			place_at_kennel(piece);
-		}
+	if (backwards) {
+		// Position from_path_idx - 1 - k ends up at bit 63 - k
+		way = std::rotl(occupied, PATH_LENGTH - from_path_idx);
+		way = reverse_bits(way);
+	} else {
+		// Position from_path_idx + 1 + k ends up at bit k
+		way = std::rotr(occupied, from_path_idx) >> 1;
+	}
+
+	way &= (UINT64_C(1) << steps) - 1;
+
+	for (; way != 0; way &= way - 1) {
+		int k = std::countr_zero(way);
+		int path_idx = positive_mod(from_path_idx + (backwards ? -(k + 1) : (k + 1)), PATH_LENGTH);
+
+		PiecePtr piece = get_piece(path_idx);
+
+		assert(piece != nullptr);
+		assert(!piece->blocking);
+		place_at_kennel(piece);
 	}
 }
 
-void BoardState::place_at_kennel(PiecePtr& piece) {
+void BoardState::place_at_kennel(PiecePtr piece) {
 	assert(piece != nullptr);
 	assert(!piece->blocking);
 
 	auto& kennel = kennels.at(piece->player);
 
 	for (int i = kennel.size() - 1; i >= 0; i--) {
-		if (kennel.at(i) == nullptr) {
+		if (kennel.at(i) == NO_PIECE) {
 			move_piece(piece, BoardPosition(Kennel, piece->player, i), false);
 
 			return;
@@ -229,37 +423,85 @@ void BoardState::place_at_kennel(PiecePtr& piece) {
 	}
 }
 
-void BoardState::move_piece(PiecePtr& piece, BoardPosition position, bool blocking) {
+void BoardState::move_piece(PiecePtr piece, BoardPosition position, bool blocking) {
 	assert(piece != nullptr);
 
-	PiecePtr& target = get_piece(position);
-	assert(target == nullptr);
+	PieceId& target = get_slot(position);
+	assert(target == NO_PIECE);
+
+	if (journal_depth > 0) {
+		record({ static_cast<PieceId>(piece->get_id()), NO_PIECE, encode_position(piece->position), piece->blocking });
+	}
+
+	get_slot(piece->position) = NO_PIECE;
+
+	zobrist_hash ^= get_zobrist_key(piece->player, piece->position, piece->blocking);
+	zobrist_hash ^= get_zobrist_key(piece->player, position, blocking);
+	toggle_occupancy(*piece);
+	update_features(*piece, -1);
 
 	piece->position = position;
 	piece->blocking = blocking;
 
-	target = piece;
-	piece = nullptr;
+	toggle_occupancy(*piece);
+	update_features(*piece, 1);
+
+	update_rank(*piece);
+
+	target = piece->get_id();
 }
 
-void BoardState::swap_pieces(PiecePtr& piece1, PiecePtr& piece2) {
+void BoardState::swap_pieces(PiecePtr piece1, PiecePtr piece2) {
 	assert(piece1 != nullptr);
 	assert(piece2 != nullptr);
 
+	if (journal_depth > 0) {
+		record({ static_cast<PieceId>(piece1->get_id()), static_cast<PieceId>(piece2->get_id()), 0, false });
+	}
+
+	zobrist_hash ^= get_zobrist_key(piece1->player, piece1->position, piece1->blocking);
+	zobrist_hash ^= get_zobrist_key(piece2->player, piece2->position, piece2->blocking);
+	toggle_occupancy(*piece1);
+	toggle_occupancy(*piece2);
+	update_features(*piece1, -1);
+	update_features(*piece2, -1);
+
 	std::swap(piece1->position, piece2->position);
-	std::swap(piece1, piece2);
+	get_slot(piece1->position) = piece1->get_id();
+	get_slot(piece2->position) = piece2->get_id();
+
+	zobrist_hash ^= get_zobrist_key(piece1->player, piece1->position, piece1->blocking);
+	zobrist_hash ^= get_zobrist_key(piece2->player, piece2->position, piece2->blocking);
+	toggle_occupancy(*piece1);
+	toggle_occupancy(*piece2);
+	update_features(*piece1, 1);
+	update_features(*piece2, 1);
+
+	update_rank(*piece1);
+	update_rank(*piece2);
 }
 
-bool BoardState::check_finish_full(int player) {
-	std::array<PiecePtr, FINISH_LENGTH>& finish = finishes.at(player);
+void BoardState::set_blocking(PiecePtr piece, bool blocking) {
+	assert(piece != nullptr);
+	assert(!blocking || piece->position == BoardPosition(get_start_path_idx(piece->player)));
 
-	for (std::size_t i = 0; i < finish.size(); i++) {
-		if (finish.at(i) == nullptr) {
-			return false;
-		}
+	if (journal_depth > 0) {
+		record({ static_cast<PieceId>(piece->get_id()), NO_PIECE, encode_position(piece->position), piece->blocking });
 	}
 
-	return true;
+	zobrist_hash ^= get_zobrist_key(piece->player, piece->position, piece->blocking);
+	toggle_occupancy(*piece);
+	update_features(*piece, -1);
+	piece->blocking = blocking;
+	zobrist_hash ^= get_zobrist_key(piece->player, piece->position, piece->blocking);
+	toggle_occupancy(*piece);
+	update_features(*piece, 1);
+
+	update_rank(*piece);
+}
+
+bool BoardState::check_finish_full(int player) {
+	return finish_masks.at(player) == (1 << FINISH_LENGTH) - 1;
 }
 
 std::vector<PieceRef> BoardState::get_pieces_in_area(int player, Area area) {
@@ -278,15 +520,15 @@ std::vector<PieceRef> BoardState::get_pieces_in_area(int player, Area area) {
 }
 
 bool BoardState::start_piece(int player, bool modify_state) {
-	PiecePtr& piece_on_start = get_start(player);
+	PiecePtr piece_on_start = get_start(player);
 
 	if (piece_on_start != nullptr && piece_on_start->blocking) {
 		// Start must not be blocked by a blocking piece
 		return false;
 	}
 
-	PiecePtr* piece;
-	bool success = get_kennel_piece(player, &piece);
+	PiecePtr piece;
+	bool success = get_kennel_piece(player, piece);
 
 	if (!success) {
 		// No piece left in kennel
@@ -294,21 +536,24 @@ bool BoardState::start_piece(int player, bool modify_state) {
 	}
 
 	if (success && modify_state) {
-		PiecePtr piece_for_kennel = piece_on_start;
-		piece_on_start = nullptr;
-
-		start_piece(*piece);
-
-		// Only place it in kennel afterwards, otherwise the piece that is starting could be in the way
-		if (piece_for_kennel != nullptr) {
-			place_at_kennel(piece_for_kennel);
+		// All changes go through the primitive moves so that they can be reverted by the journal
+		if (piece_on_start == nullptr) {
+			start_piece(piece);
+		} else if (piece_on_start->player == player) {
+			// The own piece on the start takes the place of the starting piece in the kennel. Placing it in the kennel
+			// first does not work, because it would be the next piece to start.
+			swap_pieces(piece_on_start, piece);
+			set_blocking(piece, true);
+		} else {
+			place_at_kennel(piece_on_start);
+			start_piece(piece);
 		}
 	}
 
 	return true;
 }
 
-bool BoardState::move_piece(PiecePtr& piece, int count, bool avoid_finish, bool modify_state, bool remove_all_on_way) {
+bool BoardState::move_piece(PiecePtr piece, int count, bool avoid_finish, bool modify_state, bool remove_all_on_way) {
 	if (piece == nullptr) {
 		return false;
 	}
@@ -364,12 +609,6 @@ bool BoardState::move_piece(PiecePtr& piece, int count, bool avoid_finish, bool
 	}
 
 	if (modify_state) {
-		if (undo_stack_activated && count == 1) {
-			PiecePtr previous_occupant = get_piece(position_result);
-			OneStep step(piece, piece->position, piece->blocking, previous_occupant);
-			one_step_undo_stack.push_back(step);
-		}
-
 		// Change board state
 		if (remove_all_on_way) {
 			assert(count_on_path >= 0);
@@ -377,7 +616,7 @@ bool BoardState::move_piece(PiecePtr& piece, int count, bool avoid_finish, bool
 				send_to_kennel(piece->position.idx, count_on_path);
 			}
 		} else {
-			PiecePtr& piece_to_send_back = get_piece(position_result);
+			PiecePtr piece_to_send_back = get_piece(position_result);
 			if (piece_to_send_back != nullptr) {
 				place_at_kennel(piece_to_send_back);
 			}
@@ -389,22 +628,6 @@ bool BoardState::move_piece(PiecePtr& piece, int count, bool avoid_finish, bool
 	return true;
 }
 
-// TODO Move undo stack logic into DogGame
-void BoardState::undo_one_step() {
-	assert(undo_stack_activated);
-	assert(!one_step_undo_stack.empty());
-
-	OneStep step = one_step_undo_stack.back();
-	one_step_undo_stack.pop_back();
-
-	BoardPosition current_position = step.piece->position;
-	move_piece(get_piece(step.piece->position), step.previous_position, step.was_blocking);
-
-	if (step.previous_occupant != nullptr) {
-		move_piece(get_piece(step.previous_occupant->position), current_position, false);
-	}
-}
-
 int BoardState::calc_steps_into_finish(int player, int from_path_idx, int count, bool piece_blocking, int& count_on_path_result) {
 	count_on_path_result = calc_steps_on_path(player, from_path_idx, piece_blocking, count, true);
 	int steps_into_finish = count - count_on_path_result;
@@ -437,8 +660,6 @@ bool BoardState::try_enter_finish(int player, int from_path_idx, int count, bool
 }
 
 int BoardState::possible_forward_steps_in_finish(int player, int from_finish_idx) {
-	std::array<PiecePtr, FINISH_LENGTH>& finish = finishes.at(player);
-
 	int result = 0;
 
 	if (from_finish_idx < -1) {
@@ -448,13 +669,9 @@ int BoardState::possible_forward_steps_in_finish(int player, int from_finish_idx
 
 	assert(from_finish_idx >= -1);
 
-	for (int i = from_finish_idx + 1; i < FINISH_LENGTH; i++) {
-		if (finish.at(i) == nullptr) {
-			result++;
-		} else {
-			break;
-		}
-	}
+	// Free positions until the next occupied one (or the end of the finish)
+	unsigned ahead = (finish_masks.at(player) | (1 << FINISH_LENGTH)) >> (from_finish_idx + 1);
+	result += std::countr_zero(ahead);
 
 	return result;
 }
@@ -462,35 +679,28 @@ int BoardState::possible_forward_steps_in_finish(int player, int from_finish_idx
 bool BoardState::possible_one_step_on_path(int from_path_idx, bool backwards) {
 	int step = backwards ? -1 : 1;
 	int path_idx = positive_mod(from_path_idx + step, PATH_LENGTH);
-	PiecePtr& piece = get_piece(path_idx);
 
-	return (piece == nullptr || !piece->blocking);
+	return (blocking_mask & (UINT64_C(1) << path_idx)) == 0;
 }
 
 int BoardState::possible_forward_steps_on_path(int from_path_idx, bool backwards) {
-	int step = backwards ? -1 : 1;
-
-	int result = 0;
-	int limit = backwards ? -PATH_LENGTH : PATH_LENGTH;
-
-	// TODO Loop could be made faster by going in increments of PATH_SECTION_LENGTH
-	for (int i = 0; i != limit; i += step) {
-		int path_idx = positive_mod(from_path_idx + step + i, PATH_LENGTH);
-
-		if (path_idx == from_path_idx) {
-			continue;
-		}
+	// Blocking pieces rotated such that bit k corresponds to the position k + 1 steps away. The position of the piece
+	// itself ends up at bit 63 and is ignored.
+	uint64_t ahead;
 
-		PiecePtr& piece = get_piece(path_idx);
+	if (backwards) {
+		ahead = reverse_bits(std::rotl(blocking_mask, PATH_LENGTH - from_path_idx));
+	} else {
+		ahead = std::rotr(blocking_mask, from_path_idx) >> 1;
+	}
 
-		if (piece != nullptr && piece->blocking) {
-			break;
-		}
+	ahead &= ~(UINT64_C(1) << (PATH_LENGTH - 1));
 
-		result++;
+	if (ahead == 0) {
+		return PATH_LENGTH - 1;
 	}
 
-	return result;
+	return std::countr_zero(ahead);
 }
 
 int BoardState::possible_steps_of_piece(int player, BoardPosition position, bool piece_blocking, bool backwards) {
@@ -575,20 +785,102 @@ bool BoardState::check_move_in_finish(int player, int from_finish_idx, int count
 	return true;
 }
 
-bool BoardState::move_multiple_pieces(std::vector<MoveSpecifier> move_actions, bool modify_state) {
-	// Try out the moves on a copy of the board state
-	BoardState copy = BoardState(*this);
-	bool legal = copy.move_multiple_pieces_naive(move_actions);
+bool BoardState::move_multiple_pieces(const MoveSpecifiers& move_actions, bool modify_state) {
+	// Try out the moves in place, they are reverted if one of them turns out to be illegal
+	Journal local_journal;
+	std::size_t mark = is_journaling() ? begin_journal() : begin_journal(local_journal);
+	bool legal = move_multiple_pieces_naive(move_actions);
 
 	if (legal && modify_state) {
-		legal = move_multiple_pieces_naive(move_actions);
-		assert(legal);
+		commit_journal(mark);
+	} else {
+		rollback_journal(mark);
 	}
 
 	return legal;
 }
 
-bool BoardState::swap_pieces(PiecePtr& piece_1, PiecePtr& piece_2, bool modify_state) {
+std::size_t BoardState::begin_journal(Journal& journal) {
+	assert(journal_depth == 0);
+
+	this->journal = &journal;
+	journal_depth = 1;
+
+	return journal.size();
+}
+
+std::size_t BoardState::begin_journal() {
+	assert(journal_depth > 0);
+
+	journal_depth++;
+	return journal->size();
+}
+
+void BoardState::commit_journal(__attribute__((unused)) std::size_t mark) {
+	assert(journal_depth > 0);
+	assert(mark <= journal->size());
+
+	journal_depth--;
+
+	if (journal_depth == 0) {
+		journal = nullptr;
+	}
+}
+
+void BoardState::revert_changes(const Journal& changes) {
+	assert(journal_depth == 0);
+
+	for (std::size_t i = changes.size(); i > 0; i--) {
+		revert(changes[i - 1]);
+	}
+}
+
+void BoardState::rollback_journal(std::size_t mark) {
+	assert(journal_depth > 0);
+	assert(mark <= journal->size());
+
+	// Reverting must not record new entries
+	int depth = journal_depth;
+	journal_depth = 0;
+
+	while (journal->size() > mark) {
+		revert(journal->back());
+		journal->pop_back();
+	}
+
+	journal_depth = depth - 1;
+
+	if (journal_depth == 0) {
+		journal = nullptr;
+	}
+}
+
+void BoardState::record(const JournalEntry& entry) {
+	if (journal->full()) {
+		throw std::length_error("BoardState journal is full");
+	}
+
+	journal->push_back(entry);
+}
+
+void BoardState::revert(const JournalEntry& entry) {
+	PiecePtr piece = id_to_piece(entry.piece);
+
+	if (entry.swapped_piece != NO_PIECE) {
+		swap_pieces(piece, id_to_piece(entry.swapped_piece));
+		return;
+	}
+
+	BoardPosition previous_position = decode_position(entry.previous_position);
+
+	if (previous_position == piece->position) {
+		set_blocking(piece, entry.previous_blocking);
+	} else {
+		move_piece(piece, previous_position, entry.previous_blocking);
+	}
+}
+
+bool BoardState::swap_pieces(PiecePtr piece_1, PiecePtr piece_2, bool modify_state) {
 	if (piece_1 == nullptr || piece_2 == nullptr) {
 		return false;
 	}
@@ -639,6 +931,19 @@ BoardStateRepr BoardState::get_repr() const {
 	return result;
 }
 
+uint64_t BoardState::compute_hash() const {
+	uint64_t result = 0;
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		for (int idx = 0; idx < PIECE_COUNT; idx++) {
+			const Piece& piece = pieces.at(player).at(idx);
+			result ^= get_zobrist_key(player, piece.position, piece.blocking);
+		}
+	}
+
+	return result;
+}
+
 // TODO Add more checks now that unique_ptr isn't used anymore
 // TODO the following things must be unique: piece position, piece player/idx pair
 // TODO A piece must be pointed to only once from the board
@@ -659,7 +964,7 @@ bool BoardState::check_state() const {
 		bool expect_pieces_only = false;
 
 		for (std::size_t j = 0; j != kennels.size(); j++) {
-			const PiecePtr& piece = kennels.at(player).at(j);
+			PiecePtr piece = id_to_piece(kennels.at(player).at(j));
 
 			if (piece != nullptr) {
 				if (piece->player != player) {
@@ -682,7 +987,7 @@ bool BoardState::check_state() const {
 	}
 
 	for (std::size_t i = 0; i != path.size(); i++) {
-		const PiecePtr& piece = path.at(i);
+		PiecePtr piece = get_piece(i);
 
 		if (piece != nullptr) {
 			if (piece->position != BoardPosition(i)) {
@@ -695,7 +1000,7 @@ bool BoardState::check_state() const {
 
 	for (int player = 0; player != PLAYER_COUNT; player++) {
 		for (std::size_t j = 0; j != finishes.size(); j++) {
-			const PiecePtr& piece = finishes.at(player).at(j);
+			PiecePtr piece = id_to_piece(finishes.at(player).at(j));
 
 			if (piece != nullptr) {
 				if (piece->player != player) {
@@ -717,6 +1022,59 @@ bool BoardState::check_state() const {
 		}
 	}
 
+	if (zobrist_hash != compute_hash()) {
+		goto invalid_state;
+	}
+
+	for (int player = 0; player != PLAYER_COUNT; player++) {
+		for (int i = 0; i != PATH_LENGTH; i++) {
+			PiecePtr piece = get_piece(i);
+			bool occupied = (piece != nullptr && piece->player == player);
+			bool blocking = (piece != nullptr && piece->blocking);
+
+			if (occupied != ((path_masks[player] >> i) & 1)) {
+				goto invalid_state;
+			}
+
+			if (player == 0 && blocking != ((blocking_mask >> i) & 1)) {
+				goto invalid_state;
+			}
+		}
+
+		for (int i = 0; i != FINISH_LENGTH; i++) {
+			if ((finishes.at(player).at(i) != NO_PIECE) != ((finish_masks[player] >> i) & 1)) {
+				goto invalid_state;
+			}
+		}
+
+		for (int i = 0; i != KENNEL_SIZE; i++) {
+			if ((kennels.at(player).at(i) != NO_PIECE) != ((kennel_masks[player] >> i) & 1)) {
+				goto invalid_state;
+			}
+		}
+	}
+
+	for (int player = 0; player != PLAYER_COUNT; player++) {
+		for (int idx = 0; idx != PIECE_COUNT; idx++) {
+			if (rank_progress[player][idx] != get_rank_progress(pieces[player][idx])) {
+				goto invalid_state;
+			}
+		}
+
+		for (int rank = 1; rank != PIECE_COUNT; rank++) {
+			int previous_idx = rank_order[player][rank - 1];
+			int current_idx = rank_order[player][rank];
+
+			if (rank_progress[player][previous_idx] <= rank_progress[player][current_idx]) {
+				goto invalid_state;
+			}
+		}
+	}
+
+	if (features() != compute_features()) {
+		goto invalid_state;
+	}
+
 	return true;
 
 invalid_state:
@@ -725,27 +1083,19 @@ invalid_state:
 	return false;
 }
 
-bool BoardState::move_multiple_pieces_naive(std::vector<MoveSpecifier> move_actions) {
+bool BoardState::move_multiple_pieces_naive(const MoveSpecifiers& move_actions) {
 	bool legal = true;
 
-	// All piece references are resolved in the starting position
-	// Note that it is not sufficient to resolve them to PiecePtr&
-	// because a PiecePtr essentially is a reference to a slot. If a
-	// move specifier causes another piece to be sent back to kernel,
-	// the PiecePtr of that piece would change to be nullptr.
-	// Consequently, pointers to the actual pieces are required. These
-	// pointers stay valid even if the pieces they point to are moved.
-	std::vector<Piece*> piece_ptrs;
-	for (MoveSpecifier move_specifier : move_actions) {
-		PiecePtr piece = ref_to_piece(move_specifier.piece_ref);
-		piece_ptrs.push_back(piece);
+	// All piece references are resolved in the starting position, because the ranks change while the pieces move
+	std::array<PiecePtr, MAX_MOVE_SPECIFIERS> piece_ptrs;
+	for (std::size_t i = 0; i < move_actions.size(); i++) {
+		piece_ptrs.at(i) = ref_to_piece(move_actions.at(i).get_piece_ref());
 	}
 
 	for (std::size_t i = 0; i < move_actions.size(); i++) {
-		MoveSpecifier move_action = move_actions.at(i);
+		const MoveSpecifier& move_action = move_actions.at(i);
 
-		Piece* piece_ptr = piece_ptrs.at(i);
-		PiecePtr& piece = get_piece(piece_ptr->position);
+		PiecePtr piece = piece_ptrs.at(i);
 		int count = move_action.count;
 		bool avoid_finish = move_action.avoid_finish;
 
@@ -825,7 +1175,7 @@ std::string BoardState::to_str() const {
 
 			switch (spec) {
 				case 1: {
-					const PiecePtr& piece = path.at(val);
+					PiecePtr piece = get_piece(val);
 
 					if (piece == nullptr) {
 						ss << field_char;
@@ -839,7 +1189,7 @@ std::string BoardState::to_str() const {
 					int player = val / 10;
 					int finish_idx = val % 10;
 
-					const PiecePtr& piece = finishes.at(player).at(finish_idx);
+					PiecePtr piece = get_piece(BoardPosition(Finish, player, finish_idx));
 
 					if (piece == nullptr) {
 						ss << field_char;
@@ -853,7 +1203,7 @@ std::string BoardState::to_str() const {
 					int player = val / 10;
 					int kennel_idx = val % 10;
 
-					const PiecePtr& piece = kennels.at(player).at(kennel_idx);
+					PiecePtr piece = get_piece(BoardPosition(Kennel, player, kennel_idx));
 
 					if (piece == nullptr) {
 						ss << field_char;
@@ -870,7 +1220,7 @@ std::string BoardState::to_str() const {
 				case 5: {
 					int player = val;
 					int path_idx = get_start_path_idx(player);
-					const PiecePtr& piece = path.at(path_idx);
+					PiecePtr piece = get_piece(path_idx);
 
 					if (piece != nullptr && piece->blocking) {
 						ss << blocked_char;
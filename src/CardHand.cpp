@@ -0,0 +1,28 @@
+#include <libdog/CardHand.hpp>
+
+#include <sstream>
+
+
+namespace libdog {
+
+std::vector<Card> CardHand::get_cards() const {
+	std::vector<Card> result;
+	result.reserve(size());
+
+	CardHand copy = *this;
+	copy.take_all(std::back_inserter(result));
+
+	return result;
+}
+
+std::string CardHand::to_str() const {
+	std::stringstream ss;
+
+	for (Card card : get_cards()) {
+		ss << card_to_string(card);
+	}
+
+	return ss.str();
+}
+
+}
@@ -6,33 +6,36 @@
 namespace libdog {
 
 void CardStack::remove(Card card) {
-	for (size_t i = 0; i < cards.size(); i++) {
+	for (size_t i = top; i < cards.size(); i++) {
 		if (cards.at(i) == card) {
 			cards.erase(cards.begin() + i);
 			break;
 		}
 	}
+
+	reset_if_empty();
+}
+
+void CardStack::reset_if_empty() {
+	if (top == cards.size()) {
+		cards.clear();
+		top = 0;
+	}
 }
 
-CardStack::CardStack(vector<Card> cards, default_random_engine rng) : cards(cards), rng(rng) {
+CardStack::CardStack(vector<Card> cards) : cards(cards) {
 }
 
 size_t CardStack::size() const {
-	return cards.size();
+	return cards.size() - top;
 }
 
 bool CardStack::empty() const {
-	return cards.empty();
+	return top == cards.size();
 }
 
 bool CardStack::contains(Card card) const {
-	for (Card c : cards) {
-		if (c == card) {
-			return true;
-		}
-	}
-
-	return false;
+	return std::find(cards.begin() + top, cards.end(), card) != cards.end();
 }
 
 void CardStack::move_to(CardStack& dest) {
@@ -40,35 +43,70 @@ void CardStack::move_to(CardStack& dest) {
 }
 
 void CardStack::move_to(CardStack& dest, size_t count) {
-	assert(cards.size() >= count);
+	assert(size() >= count);
+
+	dest.cards.insert(dest.cards.end(), cards.begin() + top, cards.begin() + top + count);
+	top += count;
 
-	dest.cards.insert(dest.cards.end(), cards.begin(), cards.begin() + count);
-	cards.erase(cards.begin(), cards.begin() + count);
+	reset_if_empty();
 }
 
 void CardStack::move_to(CardStack& dest, Card card) {
 	assert(contains(card));
 
-	vector<Card>::iterator it = find(cards.begin(),cards.end(), card);
+	vector<Card>::iterator it = std::find(cards.begin() + top, cards.end(), card);
 	assert(it != cards.end());
 
 	dest.cards.push_back(*it);
 	cards.erase(it);
+
+	reset_if_empty();
 }
 
-void CardStack::shuffle() {
-	::shuffle(cards.begin(), cards.end(), rng);
+void CardStack::deal_to(CardHand& dest, size_t count) {
+	assert(size() >= count);
+
+	for (size_t i = top; i < top + count; i++) {
+		dest.add(cards[i]);
+	}
+
+	top += count;
+
+	reset_if_empty();
+}
+
+void CardStack::push_back(Card card) {
+	cards.push_back(card);
+}
+
+Card CardStack::pop_back() {
+	assert(!empty());
+
+	Card card = cards.back();
+	cards.pop_back();
+
+	reset_if_empty();
+
+	return card;
+}
+
+void CardStack::shuffle(Rng& rng) {
+	// Fisher-Yates
+	for (size_t i = size(); i > 1; i--) {
+		size_t j = rng.below(i);
+		std::swap(cards[top + i - 1], cards[top + j]);
+	}
 }
 
 vector<Card> CardStack::get_cards() const {
-	return cards;
+	return vector<Card>(cards.begin() + top, cards.end());
 }
 
 string CardStack::to_str() const {
 	stringstream ss;
 
-	for (Card c : cards) {
-		ss << card_to_string(c);
+	for (size_t i = top; i < cards.size(); i++) {
+		ss << card_to_string(cards[i]);
 	}
 
 	return ss.str();
@@ -1,52 +1,99 @@
 #include <libdog/CardsState.hpp>
 
-#include "Util.hpp"
+#include <libdog/Zobrist.hpp>
 
+#include <bit>
+#include <stdexcept>
+
+
+// Upper bound of the number of cards in all hands and give buffers
+#define MAX_POOLED_CARDS (4 * 13 * DECK_COUNT + JOKER_COUNT)
 
 namespace libdog {
 
-CardsState::CardsState(vector<Card> cards) : deck(cards) {
+CardsState::CardsState(vector<Card> cards, const Rng& rng) : deck(cards), rng(rng) {
+	given_cards.fill(None);
 }
 
-CardStack& CardsState::get_hand(int player) {
+CardHand& CardsState::get_hand(int player) {
 	return hands.at(player);
 }
 
-const CardStack& CardsState::get_hand(int player) const {
+const CardHand& CardsState::get_hand(int player) const {
 	return hands.at(player);
 }
 
 void CardsState::hand_out_cards(int count) {
+	given_cards.fill(None);
+
 	for (int player = 0; player < PLAYER_COUNT; player++) {
-		CardStack& hand = get_hand(player);
+		CardHand& hand = get_hand(player);
+
+		size_t remaining = count;
+
+		// Cards are dealt in runs up to the end of the deck, the discarded cards are only shuffled back in once the
+		// deck runs out
+		while (remaining > 0) {
+			if (deck.empty()) {
+				// Only possible with a custom deck that has fewer cards than the hands need
+				throw std::length_error("Not enough cards to hand out");
+			}
 
-		for (int i = 0; i < count; i++) {
-			deck.move_to(hand, 1);
+			size_t run = std::min(remaining, deck.size());
+			deck.deal_to(hand, run);
+			remaining -= run;
 
 			if (deck.empty()) {
 				discarded.move_to(deck);
-				deck.shuffle();
+				deck.shuffle(rng);
 			}
 		}
 	}
 }
 
 bool CardsState::check_player_has_card(int player, Card card) const {
-	const CardStack& hand = get_hand(player);
+	const CardHand& hand = get_hand(player);
 	return hand.contains(card);
 }
 
 void CardsState::discard(int player, Card card) {
-	CardStack& hand = get_hand(player);
+	CardHand& hand = get_hand(player);
 
 	if (hand.contains(card)) {
-		hand.move_to(discarded, card);
+		hand.remove(card);
+		discarded.push_back(card);
+
+		// The team mate can no longer be sure that the player still holds the card they gave
+		Card& given_card = given_cards.at(GET_TEAM_PLAYER_IDX(player));
+
+		if (given_card == card) {
+			given_card = None;
+		}
+	}
+}
+
+void CardsState::undo_discard(int player, Card given_card) {
+	get_hand(player).add(discarded.pop_back());
+	given_cards.at(GET_TEAM_PLAYER_IDX(player)) = given_card;
+}
+
+uint16_t CardsState::get_hand_card_mask(int player) const {
+	return get_hand(player).get_card_mask();
+}
+
+size_t CardsState::get_hand_card_count() const {
+	size_t result = 0;
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		result += get_hand(player).size();
 	}
+
+	return result;
 }
 
 bool CardsState::hands_empty() const {
 	for (int player = 0; player < PLAYER_COUNT; player++) {
-		const CardStack& hand = get_hand(player);
+		const CardHand& hand = get_hand(player);
 
 		if (!hand.empty()) {
 			return false;
@@ -57,12 +104,16 @@ bool CardsState::hands_empty() const {
 }
 
 vector<Card> CardsState::get_hand_cards(int player, bool deduplicate) const {
-	const CardStack& hand = get_hand(player);
+	const CardHand& hand = get_hand(player);
 
-	vector<Card> result = hand.get_cards();
+	if (!deduplicate) {
+		return hand.get_cards();
+	}
+
+	vector<Card> result;
 
-	if (deduplicate) {
-		remove_duplicates(result);
+	for (uint16_t mask = hand.get_card_mask(); mask != 0; mask &= mask - 1) {
+		result.push_back(static_cast<Card>(std::countr_zero(mask)));
 	}
 
 	return result;
@@ -73,16 +124,116 @@ const CardStack& CardsState::get_deck() const {
 }
 
 void CardsState::give_card(int player, Card card) {
-	CardStack& hand = get_hand(player);
-	CardStack& player_give_buffer = give_buffer.at(player);
+	CardHand& hand = get_hand(player);
+	CardHand& player_give_buffer = give_buffer.at(player);
 
 	assert(hand.contains(card));
 
-	hand.move_to(player_give_buffer, card);
+	hand.remove(card);
+	player_give_buffer.add(card);
+	given_cards.at(player) = card;
+}
+
+void CardsState::undo_give_card(int player) {
+	CardHand& player_give_buffer = give_buffer.at(player);
+	assert(player_give_buffer.size() == 1);
+
+	Card card;
+	player_give_buffer.take_all(&card);
+	get_hand(player).add(card);
+	given_cards.at(player) = None;
+}
+
+Card CardsState::get_given_card(int player) const {
+	return given_cards.at(player);
+}
+
+void CardsState::sample_determinization(int observer, Rng& rng) {
+	int team_mate = GET_TEAM_PLAYER_IDX(observer);
+	// Until every player gave their card, the card of the observer is still in their give buffer
+	Card known_card = give_buffer.at(observer).empty() ? given_cards.at(observer) : None;
+
+	// The unknown hand and give buffer cards are taken out into a pool, the shuffle runs over the concatenation of
+	// the deck and the pool. Afterwards the stacks are refilled from the pool with their previous sizes. This way no
+	// memory is allocated.
+	std::array<Card, MAX_POOLED_CARDS> pool;
+	std::array<CardHand*, 2 * (PLAYER_COUNT - 1)> targets;
+	std::array<size_t, 2 * (PLAYER_COUNT - 1)> target_sizes;
+	size_t target_count = 0;
+	Card* pool_end = pool.data();
+
+	auto add_target = [&](CardHand& target) {
+		assert(pool_end - pool.data() + target.size() <= pool.size());
+
+		targets[target_count] = &target;
+		target_sizes[target_count] = target.size();
+		target_count++;
+		pool_end = target.take_all(pool_end);
+	};
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		if (player == observer) {
+			continue;
+		}
+
+		if (player == team_mate && known_card != None) {
+			// The card the observer gave is still in the hand of their team mate, it is kept there
+			hands[player].remove(known_card);
+			add_target(hands[player]);
+			hands[player].add(known_card);
+		} else {
+			add_target(hands[player]);
+		}
+
+		add_target(give_buffer[player]);
+	}
+
+	Card* deck_cards = deck.cards.data() + deck.top;
+	size_t deck_size = deck.size();
+	size_t total = deck_size + (pool_end - pool.data());
+
+	auto locate = [&](size_t i) -> Card& {
+		return i < deck_size ? deck_cards[i] : pool[i - deck_size];
+	};
+
+	// Fisher-Yates
+	for (size_t i = total; i > 1; i--) {
+		size_t j = rng.below(i);
+		std::swap(locate(i - 1), locate(j));
+	}
+
+	Card* next = pool.data();
+
+	for (size_t t = 0; t < target_count; t++) {
+		for (size_t i = 0; i < target_sizes[t]; i++) {
+			targets[t]->add(*next);
+			next++;
+		}
+	}
+
+	assert(next == pool_end);
+}
+
+uint64_t CardsState::hash() const {
+	uint64_t result = deck.size() * zobrist_keys.deck_card;
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		for (uint16_t mask = hands[player].get_card_mask(); mask != 0; mask &= mask - 1) {
+			Card card = static_cast<Card>(std::countr_zero(mask));
+			result += hands[player].count(card) * zobrist_keys.hand_cards[player][card];
+		}
+
+		for (uint16_t mask = give_buffer[player].get_card_mask(); mask != 0; mask &= mask - 1) {
+			Card card = static_cast<Card>(std::countr_zero(mask));
+			result += give_buffer[player].count(card) * zobrist_keys.give_buffer_cards[player][card];
+		}
+	}
+
+	return result;
 }
 
 bool CardsState::give_buffer_full(int player) {
-	CardStack& player_give_buffer = give_buffer.at(player);
+	CardHand& player_give_buffer = give_buffer.at(player);
 	return !player_give_buffer.empty();
 }
 
@@ -102,8 +253,8 @@ void CardsState::execute_give() {
 	for (int player = 0; player < PLAYER_COUNT; player++) {
 		int player_team = GET_TEAM_PLAYER_IDX(player);
 
-		CardStack& player_give_buffer = give_buffer.at(player);
-		CardStack& player_team_hand = get_hand(player_team);
+		CardHand& player_give_buffer = give_buffer.at(player);
+		CardHand& player_team_hand = get_hand(player_team);
 		player_give_buffer.move_to(player_team_hand);
 	}
 }
@@ -112,7 +263,7 @@ string CardsState::to_str() const {
 	stringstream ss;
 
 	for (int player = 0; player < PLAYER_COUNT; player++) {
-		const CardStack& hand = hands.at(player);
+		const CardHand& hand = hands.at(player);
 		ss << player << ": ";
 		ss << hand;
 		ss << std::endl;
@@ -1,14 +1,12 @@
 #include <libdog/DogGame.hpp>
+#include <libdog/Rng.hpp>
+#include <libdog/Zobrist.hpp>
 
-#include "Debug.hpp"
-
+#include <bit>
 
-#define USE_POSSIBLE_SEVENS_ITERATIVE (false)
+#include "Debug.hpp"
+#include "SevenGenerator.hpp"
 
-#define APPEND(x, y) do { \
-	auto b = (y); \
-	(x).insert((x).end(), b.begin(), b.end()); \
-} while(0);
 
 namespace libdog {
 
@@ -43,10 +41,19 @@ void DogGame::reset_with_deck(const std::vector<Card>& cards) {
 	_reset();
 }
 
+void DogGame::reset_with_seed(uint64_t seed) {
+	Rng rng(seed);
+
+	CardStack deck(get_dog_card_set());
+	deck.shuffle(rng);
+
+	board_state = BoardState();
+	cards_state = CardsState(deck.get_cards(), rng);
+	_reset();
+}
+
 void DogGame::load_board(const std::string& notation_str) {
-	bool undo_stack_activated = board_state.undo_stack_activated;
 	board_state = from_notation(notation_str);
-	board_state.undo_stack_activated = undo_stack_activated;
 
 	assert(board_state.check_state());
 }
@@ -157,7 +164,7 @@ bool DogGame::play_notation(int player, std::string notation_str, bool modify_st
 	}
 }
 
-bool DogGame::play(int player, ActionVar action, bool modify_state, bool common_checks) {
+bool DogGame::play(int player, const ActionVar& action, bool modify_state, bool common_checks) {
 	bool legal;
 
 	if (!action_is_valid(action)) {
@@ -192,6 +199,70 @@ bool DogGame::play(int player, ActionVar action, bool modify_state, bool common_
 	return legal;
 }
 
+UndoRecord DogGame::apply(const ActionVar& action) {
+	int player = player_turn;
+	Card card = action_get_card(action);
+
+	UndoRecord record;
+	record.player = player;
+	record.is_give = VAR_IS(action, Give);
+	record.from_hand = cards_state.check_player_has_card(player, card);
+	record.given_card = cards_state.get_given_card(GET_TEAM_PLAYER_IDX(player));
+	record.give_phase_done = give_phase_done;
+	record.next_hand_size = next_hand_size;
+
+	bool concludes_give_phase = record.is_give;
+	for (int i = 0; i < PLAYER_COUNT && concludes_give_phase; i++) {
+		concludes_give_phase = (i == player || cards_state.give_buffer_full(i));
+	}
+
+	// The round is over once the last hand card is played
+	bool concludes_round = !record.is_give && cards_state.get_hand_card_count() <= 1;
+
+	if (concludes_give_phase || concludes_round) {
+		record.cards_state = cards_state;
+	}
+
+	// The changes are recorded right into the undo record
+	std::size_t mark = board_state.begin_journal(record.board_changes);
+
+	__attribute__((unused)) bool legal = play(player, action);
+	assert(legal);
+
+	board_state.commit_journal(mark);
+
+	return record;
+}
+
+void DogGame::undo(const UndoRecord& record) {
+	board_state.revert_changes(record.board_changes);
+
+	if (record.cards_state.has_value()) {
+		cards_state = record.cards_state.value();
+	} else if (record.from_hand) {
+		if (record.is_give) {
+			cards_state.undo_give_card(record.player);
+		} else {
+			cards_state.undo_discard(record.player, record.given_card);
+		}
+	}
+
+	player_turn = record.player;
+	give_phase_done = record.give_phase_done;
+	next_hand_size = record.next_hand_size;
+}
+
+uint64_t DogGame::hash() const {
+	uint64_t result = board_state.hash() ^ cards_state.hash() ^ zobrist_keys.player_turn[player_turn];
+	result ^= zobrist_keys.next_hand_size.at(next_hand_size);
+
+	if (give_phase_done) {
+		result ^= zobrist_keys.give_phase_done;
+	}
+
+	return result;
+}
+
 int DogGame::switch_to_team_mate_if_done(int player) {
 	int team_mate = GET_TEAM_PLAYER_IDX(player);
 	if (board_state.check_finish_full(player) && !board_state.check_finish_full(team_mate)) {
@@ -230,8 +301,7 @@ bool DogGame::try_play(int player, const Give& give, bool modify_state) {
 }
 
 bool DogGame::try_play(int player, const Discard& discard, __attribute__((unused)) bool modify_state) {
-	std::vector<ActionVar> possible_card_plays = get_possible_card_plays(player);
-	if (!possible_card_plays.empty()) {
+	if (has_legal_card_play(player)) {
 		// Can only discard a card if none of them can be played
 		return false;
 	}
@@ -257,7 +327,7 @@ bool DogGame::try_play(int player, const Move& move, bool modify_state) {
 	int count = move.get_count();
 	bool avoid_finish = move.get_avoid_finish();
 
-	PiecePtr& piece = board_state.ref_to_piece_ptr_ref(move.get_piece_ref());
+	PiecePtr piece = board_state.ref_to_piece(move.get_piece_ref());
 
 	if (piece->player != player) {
 		return false;
@@ -271,8 +341,8 @@ bool DogGame::try_play(int player, const Move& move, bool modify_state) {
 bool DogGame::try_play(int player, const MoveMultiple& move_multiple, bool modify_state) {
 	player = switch_to_team_mate_if_done(player);
 
-	for (MoveSpecifier move_specifier : move_multiple.get_move_specifiers()) {
-		PiecePtr piece = board_state.ref_to_piece(move_specifier.piece_ref);
+	for (const MoveSpecifier& move_specifier : move_multiple.get_move_specifiers()) {
+		PiecePtr piece = board_state.ref_to_piece(move_specifier.get_piece_ref());
 
 		if (canadian_rule) {
 			if (piece->player != player && piece->player != GET_TEAM_PLAYER_IDX(player)) {
@@ -302,8 +372,8 @@ bool DogGame::try_play(int player, const MoveMultiple& move_multiple, bool modif
 bool DogGame::try_play(int player, const Swap& swap, bool modify_state) {
 	player = switch_to_team_mate_if_done(player);
 
-	PiecePtr& piece_1 = board_state.ref_to_piece_ptr_ref(swap.get_piece_1());
-	PiecePtr& piece_2 = board_state.ref_to_piece_ptr_ref(swap.get_piece_2());
+	PiecePtr piece_1 = board_state.ref_to_piece(swap.get_piece_1());
+	PiecePtr piece_2 = board_state.ref_to_piece(swap.get_piece_2());
 
 	if (piece_1->player != player && piece_2->player != player) {
 		// One of the pieces has to belong to the player that is playing the swap
@@ -315,48 +385,35 @@ bool DogGame::try_play(int player, const Swap& swap, bool modify_state) {
 	return legal;
 }
 
-std::vector<ActionVar> DogGame::possible_gives(int player) {
-	std::vector<ActionVar> result;
-
-	std::vector<Card> cards = cards_state.get_hand_cards(player, true);
+void DogGame::possible_gives(int player, ActionBuffer& out) {
+	// Iterating over the card mask of the hand yields every distinct card in the hand once, in ascending order
+	for (uint16_t mask = cards_state.get_hand_card_mask(player); mask != 0; mask &= mask - 1) {
+		Card card = static_cast<Card>(std::countr_zero(mask));
 
-	for (Card card : cards) {
 		Give give(card);
-		result.push_back(give);
+		out.push_back(give);
 	}
-
-	return result;
 }
 
-std::vector<ActionVar> DogGame::possible_discards(int player) {
-	std::vector<ActionVar> result;
-
-	std::vector<Card> cards = cards_state.get_hand_cards(player, true);
+void DogGame::possible_discards(int player, ActionBuffer& out) {
+	for (uint16_t mask = cards_state.get_hand_card_mask(player); mask != 0; mask &= mask - 1) {
+		Card card = static_cast<Card>(std::countr_zero(mask));
 
-	for (Card card : cards) {
 		Discard discard(card);
-		result.push_back(discard);
+		out.push_back(discard);
 	}
-
-	return result;
 }
 
-std::vector<ActionVar> DogGame::possible_starts(int player, Card card, bool is_joker) {
-	std::vector<ActionVar> result;
-
+void DogGame::possible_starts(int player, Card card, bool is_joker, ActionBuffer& out) {
 	Start start(card, is_joker);
 
 	bool legal = play(player, start, false, false);
 	if (legal) {
-		result.push_back(start);
+		out.push_back(start);
 	}
-
-	return result;
 }
 
-std::vector<ActionVar> DogGame::possible_moves(int player, Card card, int count, bool is_joker) {
-	std::vector<ActionVar> result;
-
+void DogGame::possible_moves(int player, Card card, int count, bool is_joker, ActionBuffer& out) {
 	for (int i = 0; i < PIECE_COUNT; i++) {
 		PieceRef piece_ref(player, i);
 		PiecePtr piece = board_state.ref_to_piece(piece_ref);
@@ -369,7 +426,7 @@ std::vector<ActionVar> DogGame::possible_moves(int player, Card card, int count,
 
 		bool legal = play(player, move, false, false);
 		if (legal) {
-			result.push_back(move);
+			out.push_back(move);
 		}
 
 		if (piece->position.area == Path) {
@@ -385,342 +442,289 @@ std::vector<ActionVar> DogGame::possible_moves(int player, Card card, int count,
 
 				legal = play(player, move, false, false);
 				if (legal) {
-					result.push_back(move);
+					out.push_back(move);
 				}
 			}
 		}
 	}
-
-	return result;
 }
 
-#if USE_POSSIBLE_SEVENS_ITERATIVE
-// TODO The iterative implementation currently does not include moves that with
-// the avoid finish flag set. In contrast, the recursive implementation does
-// include those moves.
-
-void DogGame::_possible_move_multiples_iter(my_set& s, int player, Card card, BoardState& board, size_t total_count, bool is_joker, std::vector<std::tuple<PieceRef, PiecePtr>> all_pieces) {
-	std::vector<std::vector<std::tuple<PieceRef, PiecePtr>>> pieces_stack;
-
-	std::vector<size_t> piece_indices;
-	piece_indices.resize(total_count, 0);
-
-	std::vector<MoveSpecifier> move_specifiers;
-	move_specifiers.reserve(7);
+// TODO Currently avoid_finish flag is always set to false, generate also the moves that have this flag set to true
+void DogGame::possible_move_multiples(int player, Card card, int count, bool is_joker, ActionBuffer& out) {
+	SevenGenerator generator(board_state, player, canadian_rule);
 
-	pieces_stack.push_back(all_pieces);
-	pieces_stack.reserve(7);
+#ifndef NDEBUG
+	std::size_t first = out.size();
+#endif
 
-	while (true) {
-		size_t level = move_specifiers.size();
+	generator.generate(card, count, is_joker, out);
 
-		assert(level <= total_count);
+#ifndef NDEBUG
+	for (std::size_t i = first; i < out.size(); i++) {
+		const ActionVar& action = out[i];
 
-		if (level == total_count) {
-			MoveMultiple move_mult(card, move_specifiers, is_joker);
+		assert(VAR_IS(action, MoveMultiple));
+		MATCH(&action, MoveMultiple, move_mult);
+		bool legal = play(player, action, false, false);
+		if (!legal) {
+			PRINT_DBG(board_state);
+			for (auto m : move_mult->get_move_specifiers()) {
+				PRINT_DBG(m.get_piece_ref());
+				PRINT_DBG(static_cast<int>(m.count));
+			}
+		}
+		assert(legal);
+	}
+#endif
+}
 
-			std::tuple<ActionVar, BoardStateRepr> pair = std::make_tuple(move_mult, board.get_repr());
-			s.insert(pair);
+// Only pieces on the path that are not blocking can be swapped
+static bool is_swappable(const Piece& piece) {
+	return piece.position.area == Path && !piece.blocking;
+}
 
-			move_specifiers.pop_back();
-			board.undo_one_step();
-			pieces_stack.pop_back();
-		} else {
-			assert(level < piece_indices.size());
+void DogGame::possible_swaps(int player, Card card, bool is_joker, ActionBuffer& out) {
+	uint64_t swappable = board_state.get_path_mask() & ~board_state.get_blocking_mask();
 
-			std::vector<std::tuple<PieceRef, PiecePtr>>& pieces = pieces_stack.back();
-			size_t& i = piece_indices.at(level);
+	if ((board_state.get_path_mask(player) & swappable) == 0) {
+		return;
+	}
 
-			if (i == pieces.size()) {
-				piece_indices.at(level) = 0;
+	for (int i = 0; i < PIECE_COUNT; i++) {
+		if (!is_swappable(*board_state.ref_to_piece(PieceRef(player, i)))) {
+			continue;
+		}
 
-				if (level == 0) {
-					break;
-				}
+		for (int j = 0; j < PLAYER_COUNT; j++) {
+			if ((board_state.get_path_mask(j) & swappable) == 0) {
+				continue;
+			}
 
-				assert(!move_specifiers.empty());
-				move_specifiers.pop_back();
-				board.undo_one_step();
-				pieces_stack.pop_back();
-			} else {
-				assert(i < pieces.size());
-				PiecePtr piece_ptr = std::get<1>(pieces.at(i));
-
-				PiecePtr& piece = board.get_piece(piece_ptr->position);
-				assert(piece != nullptr);
-
-				if (!RULE_ALLOW_SEVEN_MOVE_TEAMMATE_IF_BLOCKED) {
-					if (piece->player != player && piece->blocking) {
-						i++;
-						continue;
-					}
+			for (int k = 0; k < PIECE_COUNT; k++) {
+				if (!is_swappable(*board_state.ref_to_piece(PieceRef(j, k)))) {
+					continue;
 				}
 
-				PieceRef piece_ref = std::get<0>(pieces.at(i));
-				MoveSpecifier move_specifier(piece_ref, 1, false);
-
-				bool legal = board.move_piece(piece, move_specifier.count, move_specifier.avoid_finish, true, true);
+				Swap swap(card, PieceRef(player, i), PieceRef(j, k), is_joker);
 
+				bool legal = play(player, swap, false, false);
 				if (legal) {
-					std::vector<std::tuple<PieceRef, PiecePtr>> pieces_copy = pieces;
-
-					// If one piece is done adding 1-steps, the piece shall not be used again in the remaining 1-steps
-					if (!move_specifiers.empty()) {
-						PieceRef last_piece_ref = move_specifiers.back().piece_ref;
-						if (last_piece_ref != piece_ref) {
-							for (std::size_t i = 0; i < pieces_copy.size(); i++) {
-								if (std::get<0>(pieces_copy[i]) == last_piece_ref) {
-									pieces_copy.erase(pieces_copy.begin() + i);
-									break;
-								}
-							}
-						}
-					}
-
-					pieces_stack.push_back(pieces_copy);
-					move_specifiers.push_back(move_specifier);
+					out.push_back(swap);
 				}
-
-				i++;
 			}
 		}
 	}
 }
 
-#else
-
-void DogGame::descend_move(my_set& s, int player, Card card, BoardState& board, int count, bool is_joker, std::vector<std::tuple<PieceRef, PiecePtr>> pieces, std::vector<MoveSpecifier>& move_specifiers, PiecePtr& piece_ptr, PieceRef& piece_ref, PiecePtr& piece, bool avoid_finish) {
-	MoveSpecifier move_specifier(piece_ref, 1, avoid_finish);
-
-	bool legal = board.move_piece(piece, move_specifier.count, move_specifier.avoid_finish, true, true);
-
-	if (legal) {
-		std::vector<std::tuple<PieceRef, PiecePtr>> pieces_copy = pieces;
-
-		// If one piece is done adding 1-steps, the piece shall not be used again in the remaining 1-steps
-		if (!move_specifiers.empty()) {
-			PieceRef last_piece_ref = move_specifiers.back().piece_ref;
-			if (last_piece_ref != piece_ref) {
-				for (std::size_t i = 0; i < pieces_copy.size(); i++) {
-					if (std::get<0>(pieces_copy[i]) == last_piece_ref) {
-						pieces_copy.erase(pieces_copy.begin() + i);
-						break;
-					}
-				}
-			}
-		}
-
-		move_specifiers.push_back(move_specifier);
+std::vector<ActionVar> DogGame::get_possible_actions(int player) {
+	ActionBuffer result(0);
+	get_possible_actions(player, result);
+	return result.release();
+}
 
-		_possible_move_multiples(s, player, card, board, count - 1, is_joker, pieces_copy, move_specifiers);
-		move_specifiers.pop_back();
+void DogGame::get_possible_actions(int player, ActionBuffer& out) {
+	out.clear();
 
-		board.undo_one_step();
+	if (result() >= 0) {
+		// Game is already over
+		return;
 	}
-}
-
-void DogGame::_possible_move_multiples(my_set& s, int player, Card card, BoardState& board, int count, bool is_joker, std::vector<std::tuple<PieceRef, PiecePtr>> pieces, std::vector<MoveSpecifier>& move_specifiers) {
-	assert(!pieces.empty());
 
-	if (count == 0) {
-		MoveMultiple move_mult(card, move_specifiers, is_joker);
+	// TODO Maybe also return empty set if it is not player's turn
 
-		std::tuple<ActionVar, BoardStateRepr> pair = std::make_tuple(move_mult, board.get_repr());
-		s.insert(pair);
+	if (!give_phase_done) {
+		possible_gives(player, out);
 		return;
 	}
 
-	for (std::size_t i = 0; i < pieces.size(); i++) {
-		PiecePtr piece_ptr = std::get<1>(pieces.at(i));
-		PieceRef piece_ref = std::get<0>(pieces.at(i));
-
-		PiecePtr& piece = board.get_piece(piece_ptr->position);
-		assert(piece != nullptr);
+	get_possible_card_plays(player, out);
 
-		if (!RULE_ALLOW_SEVEN_MOVE_TEAMMATE_IF_BLOCKED) {
-			if (piece->player != player && piece->blocking) {
-				continue;
-			}
-		}
+	if (out.empty()) {
+		// None of the cards can be played, player can only discard one of them
 
-		descend_move(s, player, card, board, count, is_joker, pieces, move_specifiers, piece_ptr, piece_ref, piece, false);
-#if INCLUDE_AVOID_FINISH_IN_POSSIBLE_MOVES
-		descend_move(s, player, card, board, count, is_joker, pieces, move_specifiers, piece_ptr, piece_ref, piece, true);
-#endif
+		possible_discards(player, out);
 	}
-}
 
-#endif
+	// If it is a player's turn they either can play a card or discard a card
+	// It should not be possible to be next and not have a possible action (i.e. no cards in hand).
+	assert(player != player_turn || out.size() > 0);
+}
 
+void DogGame::get_possible_card_plays(int player, ActionBuffer& out) {
+	int player_to_play_for = switch_to_team_mate_if_done(player);
 
-// TODO Currently avoid_finish flag is always set to false, generate also the moves that have this flag set to true
-// TODO Consolidate consecutive moves of the same piece
-std::vector<ActionVar> DogGame::possible_move_multiples(int player, Card card, int count, bool is_joker) {
-	std::vector<ActionVar> result;
+	uint16_t hand_mask = cards_state.get_hand_card_mask(player);
 
-	std::vector<PieceRef> piece_refs;
+	// Range in out of the actions of every card in the hand
+	std::array<std::pair<std::size_t, std::size_t>, Joker> card_actions;
 
-	APPEND(piece_refs, board_state.get_pieces_in_area(player, Path));
-	APPEND(piece_refs, board_state.get_pieces_in_area(player, Finish));
+	// Process hand cards
+	for (uint16_t mask = hand_mask & ~(1 << Joker); mask != 0; mask &= mask - 1) {
+		Card card = static_cast<Card>(std::countr_zero(mask));
 
-	if (canadian_rule) {
-		APPEND(piece_refs, board_state.get_pieces_in_area(GET_TEAM_PLAYER_IDX(player), Path));
-		APPEND(piece_refs, board_state.get_pieces_in_area(GET_TEAM_PLAYER_IDX(player), Finish));
+		std::size_t first = out.size();
+		possible_actions_for_card(player_to_play_for, card, false, out);
+		card_actions[card] = { first, out.size() };
 	}
 
-	if (piece_refs.empty()) {
-		return {};
+	if (!(hand_mask & (1 << Joker))) {
+		return;
 	}
 
-	std::vector<std::tuple<PieceRef, PiecePtr>> pieces;
-
-	for (PieceRef& piece_ref : piece_refs) {
-		PiecePtr piece = board_state.ref_to_piece(piece_ref);
-		assert(piece != nullptr);
-		pieces.push_back(std::make_tuple(piece_ref, piece));
-		assert(board_state.get_piece(piece->position) != nullptr);
-	}
+	// Same actions as possible_actions_for_card() for the joker. Legality does not depend on whether a card is played
+	// as a joker, so the actions of cards in the hand are copied with the joker flag set instead of generating them
+	// again.
+	for (int i = Ace; i < Joker; i++) {
+		Card card = static_cast<Card>(i);
 
-	board_state.undo_stack_activated = true;
+		if (!(hand_mask & (1 << card))) {
+			possible_actions_for_card(player_to_play_for, card, true, out);
+			continue;
+		}
 
-	my_set s;
+		for (std::size_t j = card_actions[card].first; j < card_actions[card].second; j++) {
+			ActionVar action = out[j];
+			action_set_joker(action, true);
+			out.push_back(action);
+		}
+	}
+}
 
-#if USE_POSSIBLE_SEVENS_ITERATIVE
-	_possible_move_multiples_iter(s, player, card, board_state, count, is_joker, pieces);
-#else
-	std::vector<MoveSpecifier> move_specifiers;
-	move_specifiers.reserve(7);
-	_possible_move_multiples(s, player, card, board_state, count, is_joker, pieces, move_specifiers);
-#endif
+bool DogGame::has_legal_card_play(int player) {
+	int player_to_play_for = switch_to_team_mate_if_done(player);
 
-	board_state.undo_stack_activated = false;
+	if (cards_state.check_player_has_card(player, Joker)) {
+		// A joker can be played as any other card, so its actions include the ones of all other hand cards
+		return has_possible_action_for_card(player_to_play_for, Joker, false);
+	}
 
-	for (std::tuple<ActionVar, BoardStateRepr> x : s) {
-		ActionVar action = std::get<0>(x);
-		result.push_back(action);
+	for (uint16_t mask = cards_state.get_hand_card_mask(player); mask != 0; mask &= mask - 1) {
+		Card card = static_cast<Card>(std::countr_zero(mask));
 
-#ifndef NDEBUG
-		assert(VAR_IS(action, MoveMultiple));
-		MATCH(&action, MoveMultiple, move_mult);
-		bool legal = play(player, action, false, false);
-		if (!legal) {
-			PRINT_DBG(board_state);
-			for (auto m : move_mult->get_move_specifiers()) {
-				PRINT_DBG(m.piece_ref);
-				PRINT_DBG(m.count);
-			}
+		if (has_possible_action_for_card(player_to_play_for, card, false)) {
+			return true;
 		}
-		assert(legal);
-#endif
 	}
 
-	return result;
+	return false;
 }
 
-std::vector<ActionVar> DogGame::possible_swaps(int player, Card card, bool is_joker) {
-	std::vector<ActionVar> result;
+bool DogGame::has_possible_start(int player, Card card, bool is_joker) {
+	return play(player, Start(card, is_joker), false, false);
+}
 
+bool DogGame::has_possible_move(int player, Card card, int count, bool is_joker) {
 	for (int i = 0; i < PIECE_COUNT; i++) {
-		for (int j = 0; j < PLAYER_COUNT; j++) {
-			for (int k = 0; k < PIECE_COUNT; k++) {
-				Swap swap(card, PieceRef(player, i), PieceRef(j, k), is_joker);
+		PieceRef piece_ref(player, i);
+		PiecePtr piece = board_state.ref_to_piece(piece_ref);
 
-				bool legal = play(player, swap, false, false);
-				if (legal) {
-					result.push_back(swap);
-				}
-			}
+		if (piece->position.area == Kennel) {
+			// Pieces are ordered by rank, so all remaining pieces are in the kennel as well
+			break;
+		}
+
+		// A move with the avoid_finish flag set is only legal if the same move without the flag is legal too
+		if (play(player, Move(card, piece_ref, count, false, is_joker), false, false)) {
+			return true;
 		}
 	}
 
-	return result;
+	return false;
 }
 
-std::vector<ActionVar> DogGame::get_possible_actions(int player) {
-	if (result() >= 0) {
-		// Game is already over
-		return {};
-	}
+bool DogGame::has_possible_move_multiple(int player, int count) {
+	SevenGenerator generator(board_state, player, canadian_rule);
+	return generator.exists(count);
+}
 
-	// TODO Maybe also return empty set if it is not player's turn
+bool DogGame::has_possible_swap(int player, Card card, bool is_joker) {
+	uint64_t swappable = board_state.get_path_mask() & ~board_state.get_blocking_mask();
 
-	if (!give_phase_done) {
-		return possible_gives(player);
+	if ((board_state.get_path_mask(player) & swappable) == 0) {
+		return false;
 	}
 
-	std::vector<ActionVar> result = get_possible_card_plays(player);
-
-	if (result.empty()) {
-		// None of the cards can be played, player can only discard one of them
-
-		APPEND(result, possible_discards(player));
+	for (int i = 0; i < PIECE_COUNT; i++) {
+		for (int j = 0; j < PLAYER_COUNT; j++) {
+			for (int k = 0; k < PIECE_COUNT; k++) {
+				if (play(player, Swap(card, PieceRef(player, i), PieceRef(j, k), is_joker), false, false)) {
+					return true;
+				}
+			}
+		}
 	}
 
-	// If it is a player's turn they either can play a card or discard a card
-	// It should not be possible to be next and not have a possible action (i.e. no cards in hand).
-	assert(player != player_turn || result.size() > 0);
-
-	return result;
+	return false;
 }
 
-std::vector<ActionVar> DogGame::get_possible_card_plays(int player) {
-	std::vector<ActionVar> result;
-
-	int player_to_play_for = switch_to_team_mate_if_done(player);
-
-	// Process hand cards
-	std::vector<Card> cards = cards_state.get_hand_cards(player, true);
-
-	for (Card card : cards) {
-		std::vector<ActionVar> actions = possible_actions_for_card(player_to_play_for, card, false);
-		APPEND(result, actions);
+// Counterpart of possible_actions_for_card() that stops at the first legal action
+bool DogGame::has_possible_action_for_card(int player, Card card, bool is_joker) {
+	switch (card) {
+		case Two: case Three: case Five: case Six: case Eight: case Nine: case Ten: case Queen:
+			return has_possible_move(player, card, simple_card_get_count(card), is_joker);
+		case Ace:
+			return has_possible_start(player, card, is_joker) || has_possible_move(player, card, 1, is_joker) || has_possible_move(player, card, 11, is_joker);
+		case Four:
+			return has_possible_move(player, card, -4, is_joker) || has_possible_move(player, card, 4, is_joker);
+		case Seven:
+			return has_possible_move_multiple(player, 7);
+		case Jack:
+			return has_possible_swap(player, card, is_joker);
+		case King:
+			return has_possible_start(player, card, is_joker) || has_possible_move(player, card, 13, is_joker);
+		case Joker:
+			// Cheap cards first, the seven is only searched if nothing else is possible
+			for (Card joker_card : { King, Ace, Two, Three, Four, Five, Six, Eight, Nine, Ten, Queen, Jack, Seven }) {
+				if (has_possible_action_for_card(player, joker_card, true)) {
+					return true;
+				}
+			}
+			return false;
+		case None:
+		default:
+			return false;
 	}
-
-	return result;
 }
 
 std::vector<ActionVar> DogGame::possible_actions_for_card(int player, Card card, bool is_joker) {
-	if (card == None) {
-		return {};
-	}
-
-	std::vector<ActionVar> result;
+	ActionBuffer result(0);
+	possible_actions_for_card(player, card, is_joker, result);
+	return result.release();
+}
 
+void DogGame::possible_actions_for_card(int player, Card card, bool is_joker, ActionBuffer& out) {
 	switch (card) {
 		case Two: case Three: case Five: case Six: case Eight: case Nine: case Ten: case Queen:
-			APPEND(result, possible_moves(player, card, simple_card_get_count(card), is_joker));
+			possible_moves(player, card, simple_card_get_count(card), is_joker, out);
 			break;
 		case Ace:
-			APPEND(result, possible_starts(player, card, is_joker));
-			APPEND(result, possible_moves(player, card, 1, is_joker));
-			APPEND(result, possible_moves(player, card, 11, is_joker));
+			possible_starts(player, card, is_joker, out);
+			possible_moves(player, card, 1, is_joker, out);
+			possible_moves(player, card, 11, is_joker, out);
 			break;
 		case Four:
-			APPEND(result, possible_moves(player, card, -4, is_joker));
-			APPEND(result, possible_moves(player, card, 4, is_joker));
+			possible_moves(player, card, -4, is_joker, out);
+			possible_moves(player, card, 4, is_joker, out);
 			break;
 		case Seven:
-			APPEND(result, possible_move_multiples(player, card, 7, is_joker));
+			possible_move_multiples(player, card, 7, is_joker, out);
 			break;
 		case Jack:
-			APPEND(result, possible_swaps(player, card, is_joker));
+			possible_swaps(player, card, is_joker, out);
 			break;
 		case King:
-			APPEND(result, possible_starts(player, card, is_joker));
-			APPEND(result, possible_moves(player, card, 13, is_joker));
+			possible_starts(player, card, is_joker, out);
+			possible_moves(player, card, 13, is_joker, out);
 			break;
 		case Joker:
 			for (int i = Ace; i != Joker; i++) {
-				Card card = static_cast<Card>(i);
-				std::vector<ActionVar> actions = possible_actions_for_card(player, card, true);
-				APPEND(result, actions);
+				possible_actions_for_card(player, static_cast<Card>(i), true, out);
 			}
+			break;
 		case None:
 		default:
 			break;
 	}
-
-	return result;
 }
 
 std::string DogGame::to_str() const {
@@ -0,0 +1,479 @@
+#include <libdog/FinishTablebase.hpp>
+
+#include <libdog/BoardUtil.hpp>
+#include <libdog/CardsState.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+#define FINISH_TABLEBASE_MAGIC (0x42544644) // "DFTB"
+#define FINISH_TABLEBASE_VERSION (1)
+
+// Values that would not fit into the table are treated as unsolvable
+#define FINISH_TABLEBASE_MAX_TURNS ((FINISH_TABLEBASE_UNSOLVABLE - 1) / FINISH_TABLEBASE_SCALE)
+
+#define FINISH_TABLEBASE_EPSILON (1e-9)
+
+namespace libdog {
+
+class FinishTablebaseHeader {
+	public:
+		uint32_t magic;
+		uint32_t version;
+		uint32_t region;
+		uint32_t count;
+};
+
+static uint32_t binomial(int n, int k) {
+	if (k < 0 || n < k) {
+		return 0;
+	}
+
+	uint64_t result = 1;
+
+	for (int i = 1; i <= k; i++) {
+		result = result * (n - k + i) / i;
+	}
+
+	return result;
+}
+
+static int get_finish_cell(int region, int finish_idx) {
+	return region + 1 + finish_idx;
+}
+
+static bool is_free(uint32_t mask, int cell) {
+	return (mask & (UINT32_C(1) << cell)) == 0;
+}
+
+// Colex rank of the set of cells, consecutive masks with PIECE_COUNT bits in increasing order have consecutive ranks
+static uint32_t get_mask_index(uint32_t mask) {
+	uint32_t result = 0;
+
+	for (int i = 1; mask != 0; i++) {
+		int cell = std::countr_zero(mask);
+		result += binomial(cell, i);
+		mask &= mask - 1;
+	}
+
+	return result;
+}
+
+// Next larger number with the same number of bits set
+static uint32_t next_combination(uint32_t mask) {
+	uint32_t lowest = mask & -mask;
+	uint32_t ripple = mask + lowest;
+	return ripple | (((mask ^ ripple) >> 2) / lowest);
+}
+
+// Moves the piece on the cell count steps forward. Returns false if the move is not possible or leaves the region.
+static bool move_forward(int region, uint32_t mask, int cell, int count, uint32_t& result) {
+	int target;
+
+	if (cell <= region) {
+		if (count <= cell) {
+			target = cell - count;
+
+			if (!is_free(mask, target)) {
+				// Own piece would be sent back to the kennel
+				return false;
+			}
+		} else {
+			// Piece enters the finish, otherwise it would have to pass the start
+			int finish_idx = count - cell - 1;
+
+			if (finish_idx >= FINISH_LENGTH) {
+				return false;
+			}
+
+			target = get_finish_cell(region, finish_idx);
+
+			// Pieces in the finish cannot be passed
+			for (int other = get_finish_cell(region, 0); other <= target; other++) {
+				if (!is_free(mask, other)) {
+					return false;
+				}
+			}
+		}
+	} else {
+		target = cell + count;
+
+		if (target >= get_finish_cell(region, FINISH_LENGTH)) {
+			return false;
+		}
+
+		for (int other = cell + 1; other <= target; other++) {
+			if (!is_free(mask, other)) {
+				return false;
+			}
+		}
+	}
+
+	result = (mask & ~(UINT32_C(1) << cell)) | (UINT32_C(1) << target);
+
+	return true;
+}
+
+static bool move_backward(int region, uint32_t mask, int cell, int count, uint32_t& result) {
+	int target = cell + count;
+
+	if (cell > region || target > region || !is_free(mask, target)) {
+		return false;
+	}
+
+	result = (mask & ~(UINT32_C(1) << cell)) | (UINT32_C(1) << target);
+
+	return true;
+}
+
+// A seven is split into single steps, passing a piece with a seven is the same as landing on it
+static void append_seven_successors(int region, uint32_t mask, int remaining, std::unordered_set<uint64_t>& visited, std::vector<uint32_t>& out) {
+	if (!visited.insert((static_cast<uint64_t>(mask) << 3) | remaining).second) {
+		return;
+	}
+
+	if (remaining == 0) {
+		out.push_back(mask);
+		return;
+	}
+
+	for (uint32_t pieces = mask; pieces != 0; pieces &= pieces - 1) {
+		uint32_t next;
+
+		if (move_forward(region, mask, std::countr_zero(pieces), 1, next)) {
+			append_seven_successors(region, next, remaining - 1, visited, out);
+		}
+	}
+}
+
+// Appends the positions that can be reached with the card, duplicates are possible
+static void append_successors(int region, uint32_t mask, Card card, std::vector<uint32_t>& out) {
+	if (card == Seven) {
+		std::unordered_set<uint64_t> visited;
+		append_seven_successors(region, mask, 7, visited, out);
+		return;
+	}
+
+	std::array<int, 2> counts = { card, 0 };
+
+	switch (card) {
+		case Ace:
+			counts = { 1, 11 };
+			break;
+		case Jack:
+			// There are no other pieces to swap with
+			return;
+		case Joker:
+			assert(false);
+			return;
+		default:
+			break;
+	}
+
+	for (uint32_t pieces = mask; pieces != 0; pieces &= pieces - 1) {
+		int cell = std::countr_zero(pieces);
+		uint32_t next;
+
+		for (int count : counts) {
+			if (count > 0 && move_forward(region, mask, cell, count, next)) {
+				out.push_back(next);
+			}
+		}
+
+		if (card == Four && move_backward(region, mask, cell, 4, next)) {
+			out.push_back(next);
+		}
+	}
+}
+
+FinishTablebase::FinishTablebase(FinishTablebase&& other) noexcept {
+	*this = std::move(other);
+}
+
+FinishTablebase& FinishTablebase::operator=(FinishTablebase&& other) noexcept {
+	if (this != &other) {
+		unmap();
+
+		region = other.region;
+		values = other.values;
+		value_count = other.value_count;
+		owned_values = std::move(other.owned_values);
+		mapping = other.mapping;
+		mapping_size = other.mapping_size;
+
+		other.region = 0;
+		other.values = nullptr;
+		other.value_count = 0;
+		other.mapping = nullptr;
+		other.mapping_size = 0;
+	}
+
+	return *this;
+}
+
+FinishTablebase::~FinishTablebase() {
+	unmap();
+}
+
+void FinishTablebase::unmap() {
+	if (mapping != nullptr) {
+		munmap(mapping, mapping_size);
+		mapping = nullptr;
+		mapping_size = 0;
+	}
+}
+
+std::size_t FinishTablebase::get_position_count(int region) {
+	return binomial(region + 1 + FINISH_LENGTH, PIECE_COUNT);
+}
+
+uint32_t FinishTablebase::get_index(std::array<int, PIECE_COUNT> cells) {
+	std::sort(cells.begin(), cells.end());
+
+	uint32_t result = 0;
+
+	for (int i = 0; i < PIECE_COUNT; i++) {
+		assert(i == 0 || cells[i - 1] != cells[i]);
+		result += binomial(cells[i], i + 1);
+	}
+
+	return result;
+}
+
+FinishTablebase FinishTablebase::generate(int region) {
+	assert(0 <= region && region <= FINISH_TABLEBASE_MAX_REGION);
+
+	std::size_t count = get_position_count(region);
+	int cell_count = region + 1 + FINISH_LENGTH;
+
+	// Probability to draw each kind of card
+	std::array<double, Joker + 1> probabilities = {};
+	vector<Card> card_set = get_dog_card_set();
+
+	for (Card card : card_set) {
+		probabilities[card] += 1.0 / card_set.size();
+	}
+
+	// Successors for every position and kind of card except the joker, which can be played as any other card
+	std::vector<uint32_t> successors;
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> masks;
+	std::vector<uint32_t> buffer;
+
+	uint32_t last_mask = ((UINT32_C(1) << PIECE_COUNT) - 1) << (cell_count - PIECE_COUNT);
+
+	for (uint32_t mask = (UINT32_C(1) << PIECE_COUNT) - 1; ; mask = next_combination(mask)) {
+		assert(get_mask_index(mask) == masks.size());
+		masks.push_back(mask);
+
+		for (int card = Ace; card <= King; card++) {
+			offsets.push_back(successors.size());
+
+			buffer.clear();
+			append_successors(region, mask, static_cast<Card>(card), buffer);
+			std::sort(buffer.begin(), buffer.end());
+			buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+
+			for (uint32_t next : buffer) {
+				successors.push_back(get_mask_index(next));
+			}
+		}
+
+		if (mask == last_mask) {
+			break;
+		}
+	}
+
+	offsets.push_back(successors.size());
+	assert(masks.size() == count);
+
+	// The goal has the highest index, all finish cells come last
+	uint32_t goal = count - 1;
+	assert(masks[goal] == last_mask);
+
+	// Gauss-Seidel value iteration, the values increase monotonically towards the fixed point. Positions from which the
+	// finish cannot be reached grow without bound and are capped.
+	std::vector<double> expected(count, 0.0);
+	double max_delta;
+
+	do {
+		max_delta = 0;
+
+		for (uint32_t idx = 0; idx < count; idx++) {
+			if (idx == goal || expected[idx] >= FINISH_TABLEBASE_MAX_TURNS) {
+				continue;
+			}
+
+			double stay_probability = 0;
+			double sum = 0;
+			double joker_best = std::numeric_limits<double>::infinity();
+
+			for (int card = Ace; card <= King; card++) {
+				uint32_t begin = offsets[idx * King + card - Ace];
+				uint32_t end = offsets[idx * King + card - Ace + 1];
+
+				if (begin == end) {
+					// The card cannot be played, the turn is lost
+					stay_probability += probabilities[card];
+					continue;
+				}
+
+				double best = std::numeric_limits<double>::infinity();
+
+				for (uint32_t i = begin; i < end; i++) {
+					best = std::min(best, expected[successors[i]]);
+				}
+
+				sum += probabilities[card] * best;
+				joker_best = std::min(joker_best, best);
+			}
+
+			if (std::isinf(joker_best)) {
+				stay_probability += probabilities[Joker];
+			} else {
+				sum += probabilities[Joker] * joker_best;
+			}
+
+			double value = FINISH_TABLEBASE_MAX_TURNS;
+
+			if (stay_probability < 1) {
+				value = std::min(value, (1 + sum) / (1 - stay_probability));
+			}
+
+			max_delta = std::max(max_delta, std::abs(value - expected[idx]));
+			expected[idx] = value;
+		}
+	} while (max_delta > FINISH_TABLEBASE_EPSILON);
+
+	FinishTablebase result;
+	result.region = region;
+	result.owned_values.resize(count);
+
+	for (uint32_t idx = 0; idx < count; idx++) {
+		if (expected[idx] >= FINISH_TABLEBASE_MAX_TURNS) {
+			result.owned_values[idx] = FINISH_TABLEBASE_UNSOLVABLE;
+		} else {
+			result.owned_values[idx] = std::lround(expected[idx] * FINISH_TABLEBASE_SCALE);
+		}
+	}
+
+	result.values = result.owned_values.data();
+	result.value_count = count;
+
+	return result;
+}
+
+bool FinishTablebase::save(const std::string& path) const {
+	std::ofstream file(path, std::ios::binary);
+
+	if (!file) {
+		return false;
+	}
+
+	FinishTablebaseHeader header = { FINISH_TABLEBASE_MAGIC, FINISH_TABLEBASE_VERSION, static_cast<uint32_t>(region), static_cast<uint32_t>(value_count) };
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(values), value_count * sizeof(uint16_t));
+
+	return static_cast<bool>(file);
+}
+
+bool FinishTablebase::load(const std::string& path) {
+	int fd = open(path.c_str(), O_RDONLY);
+
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat file_stat;
+	void* file_mapping = MAP_FAILED;
+
+	if (fstat(fd, &file_stat) == 0 && static_cast<std::size_t>(file_stat.st_size) >= sizeof(FinishTablebaseHeader)) {
+		file_mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	}
+
+	// The mapping stays valid after the file is closed
+	close(fd);
+
+	if (file_mapping == MAP_FAILED) {
+		return false;
+	}
+
+	std::size_t file_size = file_stat.st_size;
+	const FinishTablebaseHeader* header = static_cast<const FinishTablebaseHeader*>(file_mapping);
+
+	bool valid = header->magic == FINISH_TABLEBASE_MAGIC
+		&& header->version == FINISH_TABLEBASE_VERSION
+		&& header->region <= FINISH_TABLEBASE_MAX_REGION
+		&& header->count == get_position_count(header->region)
+		&& file_size == sizeof(FinishTablebaseHeader) + header->count * sizeof(uint16_t);
+
+	if (!valid) {
+		munmap(file_mapping, file_size);
+		return false;
+	}
+
+	unmap();
+	owned_values.clear();
+
+	mapping = file_mapping;
+	mapping_size = file_size;
+	region = header->region;
+	values = reinterpret_cast<const uint16_t*>(static_cast<const char*>(file_mapping) + sizeof(FinishTablebaseHeader));
+	value_count = header->count;
+
+	return true;
+}
+
+bool FinishTablebase::probe(const BoardState& board_state, int player, double& expected_turns) const {
+	if (values == nullptr) {
+		return false;
+	}
+
+	std::array<int, PIECE_COUNT> cells;
+
+	for (int idx = 0; idx < PIECE_COUNT; idx++) {
+		const Piece& piece = board_state.pieces.at(player).at(idx);
+
+		switch (piece.position.area) {
+			case Path: {
+				int steps_to_start = calc_steps_to_start(player, piece.position.idx);
+
+				// A piece that blocks the start still has to go around the whole path
+				if (piece.blocking || steps_to_start > region) {
+					return false;
+				}
+
+				cells[idx] = steps_to_start;
+				break;
+			}
+			case Finish:
+				cells[idx] = get_finish_cell(region, piece.position.idx);
+				break;
+			default:
+				return false;
+		}
+	}
+
+	uint16_t value = values[get_index(cells)];
+
+	if (value == FINISH_TABLEBASE_UNSOLVABLE) {
+		return false;
+	}
+
+	expected_turns = static_cast<double>(value) / FINISH_TABLEBASE_SCALE;
+
+	return true;
+}
+
+}
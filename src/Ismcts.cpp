@@ -0,0 +1,317 @@
+#include <libdog/Ismcts.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cassert>
+#include <thread>
+
+
+#define ISMCTS_ROOT (0)
+
+namespace libdog {
+
+const ActionVar& IsmctsResult::best_action() const {
+	assert(!actions.empty());
+
+	auto best = std::max_element(actions.begin(), actions.end(), [](const IsmctsActionStats& a, const IsmctsActionStats& b) {
+		return a.visits < b.visits;
+	});
+
+	return best->action;
+}
+
+void Ismcts::Node::init(const ActionVar& action, int player) {
+	this->action = action;
+	this->player = player;
+	visits.store(0, std::memory_order_relaxed);
+	availability.store(0, std::memory_order_relaxed);
+	virtual_losses.store(0, std::memory_order_relaxed);
+	reward.store(0, std::memory_order_relaxed);
+	first_child.store(ISMCTS_NO_NODE, std::memory_order_relaxed);
+	next_sibling = ISMCTS_NO_NODE;
+}
+
+Ismcts::Worker::Worker(const IsmctsConfig& config, uint64_t seed) : rng(seed), playout(config.rollout_policy, ~seed, config.rollout_max_moves), determinization(true) {
+}
+
+Ismcts::Ismcts(const IsmctsConfig& config) : config(config) {
+	assert(config.iterations > 0 || config.time_limit > 0);
+	assert(config.max_nodes > 0);
+
+	chunk_count = (config.max_nodes - 1) / ISMCTS_NODE_CHUNK_SIZE + 1;
+	chunks = std::make_unique<std::atomic<Node*>[]>(chunk_count);
+
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		chunks[i].store(nullptr, std::memory_order_relaxed);
+	}
+
+	unsigned thread_count = config.thread_count;
+
+	if (thread_count == 0) {
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// The first worker uses the seed itself, so a single-threaded search does not depend on the thread count setting
+	for (unsigned i = 0; i < thread_count; i++) {
+		workers.emplace_back(config, config.seed + i);
+	}
+}
+
+Ismcts::~Ismcts() {
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		delete[] chunks[i].load(std::memory_order_relaxed);
+	}
+}
+
+void Ismcts::ensure_chunk(uint32_t idx) {
+	std::atomic<Node*>& chunk = chunks[idx >> ISMCTS_NODE_CHUNK_BITS];
+
+	if (chunk.load(std::memory_order_acquire) != nullptr) {
+		return;
+	}
+
+	// Several workers may get here at the same time, only the first one installs its chunk
+	Node* allocated = new Node[ISMCTS_NODE_CHUNK_SIZE];
+	Node* expected = nullptr;
+
+	if (!chunk.compare_exchange_strong(expected, allocated, std::memory_order_acq_rel, std::memory_order_acquire)) {
+		delete[] allocated;
+	}
+}
+
+IsmctsResult Ismcts::search(const DogGame& game) {
+	auto start = std::chrono::steady_clock::now();
+	int observer = game.player_turn;
+
+	// Every iteration adds at most one node
+	node_capacity = config.max_nodes;
+
+	if (config.iterations > 0 && config.iterations < node_capacity) {
+		node_capacity = config.iterations + 1;
+	}
+
+	ensure_chunk(ISMCTS_ROOT);
+	get_node(ISMCTS_ROOT).init(Give(None), -1);
+	node_count.store(1, std::memory_order_relaxed);
+
+	std::atomic<uint64_t> started = 0;
+	std::atomic<uint64_t> completed = 0;
+
+	auto work = [&](Worker& worker) {
+		while (true) {
+			if (config.time_limit > 0) {
+				double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+				if (elapsed >= config.time_limit) {
+					break;
+				}
+			}
+
+			if (config.iterations > 0 && started.fetch_add(1, std::memory_order_relaxed) >= config.iterations) {
+				break;
+			}
+
+			iterate(worker, game, observer);
+			completed.fetch_add(1, std::memory_order_relaxed);
+		}
+	};
+
+	// The calling thread acts as the first worker
+	std::vector<std::thread> threads;
+
+	for (std::size_t i = 1; i < workers.size(); i++) {
+		threads.emplace_back(work, std::ref(workers[i]));
+	}
+
+	work(workers[0]);
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	IsmctsResult result;
+	result.iterations = completed.load();
+	result.node_count = std::min(node_count.load(), node_capacity);
+
+	// Children are prepended, so walking the list yields them in reverse order of their expansion
+	for (uint32_t child = get_node(ISMCTS_ROOT).first_child; child != ISMCTS_NO_NODE; child = get_node(child).next_sibling) {
+		const Node& node = get_node(child);
+		uint64_t visits = node.visits;
+		double mean_value = visits == 0 ? 0.0 : node.reward / 2.0 / visits;
+		result.actions.push_back({ node.action, visits, node.availability, mean_value });
+	}
+
+	std::reverse(result.actions.begin(), result.actions.end());
+
+	return result;
+}
+
+void Ismcts::iterate(Worker& worker, const DogGame& game, int observer) {
+	DogGame& determinization = worker.determinization;
+	determinization = game;
+	determinization.cards_state.sample_determinization(observer, worker.rng);
+
+	worker.path.clear();
+	enter(worker, ISMCTS_ROOT);
+
+	uint32_t current = ISMCTS_ROOT;
+
+	while (determinization.result() == -1) {
+		int player = determinization.player_turn;
+		determinization.get_possible_actions(player, worker.actions);
+
+		worker.available.clear();
+		worker.untried.clear();
+
+		uint32_t first_child = get_node(current).first_child.load(std::memory_order_acquire);
+
+		// Children are matched by their action, the same action sequence always leads to the same player's turn
+		for (uint32_t i = 0; i < worker.actions.size(); i++) {
+			bool found = false;
+
+			for (uint32_t child = first_child; child != ISMCTS_NO_NODE; child = get_node(child).next_sibling) {
+				if (get_node(child).action == worker.actions[i]) {
+					worker.available.push_back(child);
+					found = true;
+					break;
+				}
+			}
+
+			if (!found) {
+				worker.untried.push_back(i);
+			}
+		}
+
+		for (uint32_t child : worker.available) {
+			get_node(child).availability.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		if (!worker.untried.empty()) {
+			uint32_t child = expand(worker, current, player);
+
+			if (child == ISMCTS_NO_NODE) {
+				// Pool is exhausted, the rollout starts from the current node
+				break;
+			}
+
+			current = child;
+			enter(worker, current);
+
+			__attribute__((unused)) bool legal = determinization.play(player, get_node(current).action, true, false);
+			assert(legal);
+
+			break;
+		}
+
+		current = select_child(worker);
+		enter(worker, current);
+
+		__attribute__((unused)) bool legal = determinization.play(player, get_node(current).action, true, false);
+		assert(legal);
+	}
+
+	int winner = determinization.result();
+
+	if (winner == -1) {
+		winner = worker.playout.run(determinization).winner;
+	}
+
+	backpropagate(worker, winner);
+}
+
+uint32_t Ismcts::select_child(const Worker& worker) {
+	assert(!worker.available.empty());
+
+	uint32_t best = worker.available.front();
+	double best_value = -1;
+
+	for (uint32_t child : worker.available) {
+		const Node& node = get_node(child);
+		uint64_t visits = node.visits.load(std::memory_order_relaxed) + node.virtual_losses.load(std::memory_order_relaxed);
+
+		if (visits == 0) {
+			// Expanded by another worker that did not enter it yet
+			return child;
+		}
+
+		double mean = node.reward.load(std::memory_order_relaxed) / 2.0 / visits;
+		double value = mean + config.exploration * std::sqrt(std::log(node.availability.load(std::memory_order_relaxed)) / visits);
+
+		if (value > best_value) {
+			best_value = value;
+			best = child;
+		}
+	}
+
+	return best;
+}
+
+uint32_t Ismcts::expand(Worker& worker, uint32_t parent, int player) {
+	const ActionVar& action = worker.actions[worker.untried[worker.rng.below(worker.untried.size())]];
+
+	// Checked first, so that the counter does not keep growing once the pool is exhausted
+	if (node_count.load(std::memory_order_relaxed) >= node_capacity) {
+		return ISMCTS_NO_NODE;
+	}
+
+	uint32_t child = node_count.fetch_add(1, std::memory_order_relaxed);
+
+	if (child >= node_capacity) {
+		return ISMCTS_NO_NODE;
+	}
+
+	ensure_chunk(child);
+
+	Node& node = get_node(child);
+	node.init(action, player);
+	node.availability.store(1, std::memory_order_relaxed);
+
+	std::atomic<uint32_t>& head = get_node(parent).first_child;
+	uint32_t expected = head.load(std::memory_order_acquire);
+
+	while (true) {
+		node.next_sibling = expected;
+
+		if (head.compare_exchange_weak(expected, child, std::memory_order_release, std::memory_order_acquire)) {
+			return child;
+		}
+
+		// Another worker added children in the meantime, it may have expanded the same action. The allocated node
+		// is wasted in that case.
+		for (uint32_t other = expected; other != node.next_sibling; other = get_node(other).next_sibling) {
+			if (get_node(other).action == action) {
+				get_node(other).availability.fetch_add(1, std::memory_order_relaxed);
+				return other;
+			}
+		}
+	}
+}
+
+void Ismcts::enter(Worker& worker, uint32_t node) {
+	worker.path.push_back(node);
+	get_node(node).virtual_losses.fetch_add(config.virtual_loss, std::memory_order_relaxed);
+}
+
+void Ismcts::backpropagate(Worker& worker, int winner) {
+	for (uint32_t idx : worker.path) {
+		Node& node = get_node(idx);
+
+		// The visit is added before the virtual loss is removed, so the node never appears unvisited in between
+		node.visits.fetch_add(1, std::memory_order_relaxed);
+		node.virtual_losses.fetch_sub(config.virtual_loss, std::memory_order_relaxed);
+
+		if (idx == ISMCTS_ROOT) {
+			continue;
+		}
+
+		if (winner == -1) {
+			// Rollout hit the move limit
+			node.reward.fetch_add(1, std::memory_order_relaxed);
+		} else if (node.player % 2 == winner) {
+			node.reward.fetch_add(2, std::memory_order_relaxed);
+		}
+	}
+}
+
+}
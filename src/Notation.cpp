@@ -1,5 +1,7 @@
 #include <libdog/Notation.hpp>
 
+#include <array>
+#include <cctype>
 #include <regex>
 
 #include "Util.hpp"
@@ -152,10 +154,15 @@ optional<ActionVar> notation_parse_seven(int player, string notation_arg_str) {
 	sregex_iterator end = sregex_iterator();
 	iter = sregex_iterator(notation_arg_str.begin(), notation_arg_str.end(), regex_inner);
 
-	std::vector<MoveSpecifier> move_specifiers;
+	MoveSpecifiers move_specifiers;
 
 	for(; iter != end; iter++)
 	{
+		if (move_specifiers.full()) {
+			// A seven cannot be split into more moves than it has steps
+			return nullopt;
+		}
+
 		int rank = stoi(iter->str(1));
 
 		if (!IS_VALID_PIECE_RANK(rank)) {
@@ -382,15 +389,15 @@ string notation_move_multiple(int player, MoveMultiple move_multiple) {
 	ss << card_to_string(move_multiple.get_card_raw());
 
 	for (std::size_t i = 0; i < move_multiple.get_move_specifiers().size(); i++) {
-		MoveSpecifier move_specifier = move_multiple.get_move_specifiers().at(i);
+		const MoveSpecifier& move_specifier = move_multiple.get_move_specifiers().at(i);
 
-		ss << move_specifier.piece_ref.rank;
+		ss << static_cast<int>(move_specifier.piece_rank);
 
-		if (player != move_specifier.piece_ref.player) {
+		if (player != move_specifier.piece_player) {
 			ss << "'";
 		}
 
-		ss << move_specifier.count;
+		ss << static_cast<int>(move_specifier.count);
 
 		if (move_specifier.avoid_finish) {
 			ss << "-";
@@ -445,74 +452,106 @@ std::string to_notation(int player, ActionVar action) {
 	return ss.str();
 }
 
-BoardState from_notation(string notation_str) {
+BoardState from_notation(std::string_view notation_str) {
 	optional<BoardState> board_opt = try_parse_notation(notation_str);
 	return board_opt.value();
 }
 
-optional<BoardState> try_parse_notation(string notation_str) {
-	erase_whitespace(notation_str);
+optional<BoardState> try_parse_notation(std::string_view notation_str) {
+	class PieceNotation {
+		public:
+			bool in_finish;
+			int idx;
+			bool blocking;
+	};
+
+	// The string is checked completely before any piece is placed
+	std::array<std::array<PieceNotation, PIECE_COUNT>, PLAYER_COUNT> pieces;
+	std::array<int, PLAYER_COUNT> piece_counts = {};
+	int player = 0;
 
-	regex regex_outer(R"((^|\|?([FP]\d{1,2}\*?)*)*)");
-	regex regex_inner_1(R"((^|\|)(([FP]\d{1,2}\*?)*))");
-	regex regex_inner_2(R"(([FP])(\d{1,2})(\*?))");
-	smatch matches;
+	std::size_t pos = 0;
 
-	bool match = regex_match(notation_str, matches, regex_outer);
+	// Whitespace is ignored everywhere, returns -1 at the end of the string
+	auto peek = [&]() -> int {
+		while (pos < notation_str.size() && std::isspace(static_cast<unsigned char>(notation_str[pos]))) {
+			pos++;
+		}
 
-	if (!match) {
-		return nullopt;
-	}
+		return pos < notation_str.size() ? static_cast<unsigned char>(notation_str[pos]) : -1;
+	};
 
-	BoardState result;
+	for (int c = peek(); c != -1; c = peek()) {
+		pos++;
 
-	sregex_iterator iter_inner_1;
-	sregex_iterator end_inner_1 = sregex_iterator();
-	iter_inner_1 = sregex_iterator(notation_str.begin(), notation_str.end(), regex_inner_1);
+		if (c == '|') {
+			player++;
 
-	int player = 0;
+			if (player >= PLAYER_COUNT) {
+				// The notation string had too many pipe separators ('|')
+				return nullopt;
+			}
+
+			continue;
+		}
 
-	for(; iter_inner_1 != end_inner_1; iter_inner_1++) {
-		if (player >= PLAYER_COUNT) {
-			// The notation string had too many pipe separators ('|')
+		if (c != 'P' && c != 'F') {
 			return nullopt;
 		}
 
-		string player_str = iter_inner_1->str(0);
+		// One or two digits, a third digit is rejected as it cannot start a piece
+		int idx = 0;
+		int digit_count = 0;
 
-		sregex_iterator iter_inner_2;
-		sregex_iterator end_inner_2 = sregex_iterator();
-		iter_inner_2 = sregex_iterator(player_str.begin(), player_str.end(), regex_inner_2);
+		for (; digit_count < 2 && std::isdigit(peek()); digit_count++) {
+			idx = 10 * idx + (notation_str[pos] - '0');
+			pos++;
+		}
 
-		int piece_cnt = 0;
+		if (digit_count == 0) {
+			return nullopt;
+		}
 
-		for(; iter_inner_2 != end_inner_2; iter_inner_2++) {
-			if (piece_cnt >= PIECE_COUNT) {
-				// Position of more pieces specified than there exist
-				return nullopt;
-			}
+		bool blocking = (peek() == '*');
 
-			string area_str = iter_inner_2->str(1);
-			int idx = stoi(iter_inner_2->str(2));
-			bool blocking = (iter_inner_2->str(3) == "*");
+		if (blocking) {
+			pos++;
+		}
+
+		if (piece_counts[player] >= PIECE_COUNT) {
+			// Position of more pieces specified than there exist
+			return nullopt;
+		}
+
+		pieces[player][piece_counts[player]] = { c == 'F', idx, blocking };
+		piece_counts[player]++;
+	}
+
+	if (player != PLAYER_COUNT - 1) {
+		// The notation string did not have the correct amount of pipe separators ('|')
+		return nullopt;
+	}
+
+	BoardState result;
+
+	for (player = 0; player < PLAYER_COUNT; player++) {
+		for (int i = 0; i < piece_counts[player]; i++) {
+			const PieceNotation& piece_notation = pieces[player][i];
 
 			// TODO Is is not a good initialization
 			BoardPosition position = BoardPosition(0);
-			if (area_str == "P") {
-				if (idx >= PATH_LENGTH) {
+			if (!piece_notation.in_finish) {
+				if (piece_notation.idx >= PATH_LENGTH) {
 					// Invalid path index
 					return nullopt;
 				}
-				position = BoardPosition(idx);
-			} else if (area_str == "F") {
-				if (idx >= FINISH_LENGTH) {
+				position = BoardPosition(piece_notation.idx);
+			} else {
+				if (piece_notation.idx >= FINISH_LENGTH) {
 					// Invalid finish index
 					return nullopt;
 				}
-				position = BoardPosition(Finish, player, idx);
-			} else {
-				// Should never happen in regex matched
-				assert(false);
+				position = BoardPosition(Finish, player, piece_notation.idx);
 			}
 
 			if (result.get_piece(position) != nullptr) {
@@ -520,22 +559,13 @@ optional<BoardState> try_parse_notation(string notation_str) {
 				return nullopt;
 			}
 
-			PiecePtr* piece = nullptr;
-			bool success = result.get_kennel_piece(player, &piece);
+			PiecePtr piece = nullptr;
+			bool success = result.get_kennel_piece(player, piece);
 			assert(success);
 
-			result.move_piece(*piece, position, blocking);
+			result.move_piece(piece, position, piece_notation.blocking);
 			assert(result.check_state());
-
-			piece_cnt++;
 		}
-
-		player++;
-	}
-
-	if (player != PLAYER_COUNT) {
-		// The notation string did not have the correct amount of pipe separators ('|')
-		return nullopt;
 	}
 
 	return result;
@@ -545,7 +575,7 @@ std::string board_notation_player(BoardState board, int player) {
 	std::stringstream ss;
 
 	for (std::size_t i = 0; i < board.path.size(); i++) {
-		PiecePtr& piece = board.path.at(i);
+		PiecePtr piece = board.get_piece(i);
 		if (piece != nullptr && piece->player == player) {
 			ss << "P" << i;
 			if (piece->blocking) {
@@ -555,7 +585,7 @@ std::string board_notation_player(BoardState board, int player) {
 	}
 
 	for (std::size_t i = 0; i < board.finishes.at(player).size(); i++) {
-		PiecePtr& piece = board.finishes.at(player).at(i);
+		PiecePtr piece = board.get_piece(BoardPosition(Finish, player, i));
 		if (piece != nullptr && piece->player == player) {
 			ss << "F" << i;
 		}
@@ -0,0 +1,61 @@
+#include <libdog/Perft.hpp>
+
+#include <cassert>
+
+
+namespace libdog {
+
+std::array<std::string, ACTION_TYPE_COUNT> action_type_names = { "Give", "Discard", "Start", "Move", "MoveMultiple", "Swap" };
+
+PerftResult& PerftResult::operator+=(const PerftResult& other) {
+	nodes += other.nodes;
+
+	for (std::size_t i = 0; i < action_type_counts.size(); i++) {
+		action_type_counts[i] += other.action_type_counts[i];
+	}
+
+	return *this;
+}
+
+std::string get_action_type_name(std::size_t action_type) {
+	return action_type_names.at(action_type);
+}
+
+static void perft(DogGame& game, int depth, std::vector<ActionBuffer>& buffers, PerftResult& result) {
+	int player = game.player_turn;
+
+	ActionBuffer& actions = buffers.at(depth - 1);
+	game.get_possible_actions(player, actions);
+
+	for (const ActionVar& action : actions) {
+		if (depth == 1) {
+			result.nodes++;
+			result.action_type_counts.at(action.index())++;
+			continue;
+		}
+
+		UndoRecord record = game.apply(action);
+		perft(game, depth - 1, buffers, result);
+		game.undo(record);
+	}
+}
+
+PerftResult perft(DogGame& game, int depth) {
+	assert(depth >= 0);
+
+	PerftResult result;
+
+	if (depth == 0) {
+		result.nodes = 1;
+		return result;
+	}
+
+	// One buffer per level so that the action lists of the ancestors stay intact while descending
+	std::vector<ActionBuffer> buffers(depth);
+
+	perft(game, depth, buffers, result);
+
+	return result;
+}
+
+}
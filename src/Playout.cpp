@@ -0,0 +1,86 @@
+#include <libdog/Playout.hpp>
+
+#include <cassert>
+#include <limits>
+
+
+namespace libdog {
+
+int evaluate_progress(const BoardState& board_state) {
+	// Progress is maintained incrementally by the board state
+	BoardFeatures features = board_state.features();
+	const std::array<int, PLAYER_COUNT>& progress = features.progress;
+
+	return progress[0] + progress[2] - progress[1] - progress[3];
+}
+
+std::size_t uniform_random_policy(__attribute__((unused)) DogGame& game, const ActionBuffer& actions, Rng& rng) {
+	return rng.below(actions.size());
+}
+
+std::size_t greedy_policy(DogGame& game, const ActionBuffer& actions, Rng& rng) {
+	int player = game.player_turn;
+
+	std::size_t selection = 0;
+	int best_score = std::numeric_limits<int>::min();
+	uint32_t tie_count = 0;
+
+	for (std::size_t i = 0; i < actions.size(); i++) {
+		UndoRecord record = game.apply(actions[i]);
+		int score = evaluate_progress(game.board_state);
+		game.undo(record);
+
+		if (player % 2 == 1) {
+			score = -score;
+		}
+
+		if (score > best_score) {
+			best_score = score;
+			selection = i;
+			tie_count = 1;
+		} else if (score == best_score) {
+			// Reservoir sampling among the best actions
+			tie_count++;
+
+			if (rng.below(tie_count) == 0) {
+				selection = i;
+			}
+		}
+	}
+
+	return selection;
+}
+
+Playout::Playout(PlayoutPolicy policy, uint64_t seed, int max_moves) : policy(policy), rng(seed), max_moves(max_moves), game(true) {
+}
+
+PlayoutResult Playout::run(const DogGame& start) {
+	game = start;
+
+	PlayoutResult result;
+
+	while ((result.winner = game.result()) == -1) {
+		if (max_moves > 0 && result.move_count >= max_moves) {
+			break;
+		}
+
+		int player = game.player_turn;
+		game.get_possible_actions(player, actions);
+		assert(!actions.empty());
+		result.action_count += actions.size();
+
+		std::size_t selection = policy(game, actions, rng);
+
+		// The generated actions are legal, so the checks that are common to all actions can be skipped
+		__attribute__((unused)) bool legal = game.play(player, actions[selection], true, false);
+		assert(legal);
+
+		result.move_count++;
+	}
+
+	assert(result.winner != 2);
+
+	return result;
+}
+
+}
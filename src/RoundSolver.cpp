@@ -0,0 +1,250 @@
+#include <libdog/RoundSolver.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+
+#define SOLVER_INFINITY (SOLVER_WIN_VALUE + 1)
+
+namespace libdog {
+
+RoundSolver::RoundSolver(const RoundSolverConfig& config) : config(config), table(config.table) {
+	if (table == nullptr && config.table_size > 0) {
+		own_table = std::make_unique<TranspositionTable>(config.table_size);
+		table = own_table.get();
+	}
+}
+
+int RoundSolver::get_remaining_actions(DogGame& game) {
+	int result = game.cards_state.get_hand_card_count();
+
+	if (!game.give_phase_done) {
+		for (int player = 0; player < PLAYER_COUNT; player++) {
+			if (!game.cards_state.give_buffer_full(player)) {
+				result++;
+			}
+		}
+	}
+
+	return result;
+}
+
+RoundSolverResult RoundSolver::solve(DogGame& game) {
+	RoundSolverResult result;
+	nodes = 0;
+
+	int root_team = game.player_turn % 2;
+	int winner = game.result();
+
+	if (winner != -1) {
+		// Nothing to search, the value is final regardless of the depth
+		result.value = winner == root_team ? SOLVER_WIN_VALUE : -SOLVER_WIN_VALUE;
+		return result;
+	}
+
+	int depth = get_remaining_actions(game);
+
+	if (config.max_depth > 0) {
+		depth = std::min(depth, config.max_depth);
+	}
+
+	if (depth > static_cast<int>(actions.size())) {
+		actions.resize(depth);
+		orders.resize(depth);
+	}
+
+	std::vector<UndoRecord> records;
+
+	// The line is collected by searching every position along it again, these searches are answered by the table
+	// unless it is disabled
+	for (int ply = 0; ply < depth && game.result() == -1; ply++) {
+		int best_idx = -1;
+		int value = search(game, depth - ply, ply, -SOLVER_INFINITY, SOLVER_INFINITY, best_idx);
+		assert(best_idx >= 0);
+
+		if (ply == 0) {
+			result.value = value;
+		}
+
+		// A search that was answered by the table does not generate the actions
+		game.get_possible_actions(game.player_turn, actions[ply]);
+		assert(best_idx < static_cast<int>(actions[ply].size()));
+
+		const ActionVar& action = actions[ply][best_idx];
+		result.line.push_back(action);
+		records.push_back(game.apply(action));
+
+		bool round_over = !records.back().is_give && records.back().cards_state.has_value();
+
+		if (round_over) {
+			break;
+		}
+	}
+
+	for (auto it = records.rbegin(); it != records.rend(); it++) {
+		game.undo(*it);
+	}
+
+	if (depth == 0) {
+		result.value = config.evaluation(game.board_state) * (root_team == 0 ? 1 : -1);
+	}
+
+	result.nodes = nodes;
+
+	return result;
+}
+
+int RoundSolver::evaluate_action(DogGame& game, const UndoRecord& record, int team, bool& is_leaf) {
+	int winner = game.result();
+
+	if (winner != -1) {
+		is_leaf = true;
+		return winner == team ? SOLVER_WIN_VALUE : -SOLVER_WIN_VALUE;
+	}
+
+	// The round ended with the action, the next round has already been dealt
+	is_leaf = !record.is_give && record.cards_state.has_value();
+
+	int value = config.evaluation(game.board_state);
+	assert(-SOLVER_WIN_VALUE < value && value < SOLVER_WIN_VALUE);
+
+	return team == 0 ? value : -value;
+}
+
+int RoundSolver::search(DogGame& game, int depth, int ply, int alpha, int beta, int& best_idx) {
+	assert(depth > 0);
+
+	nodes++;
+
+	int team = game.player_turn % 2;
+	uint64_t key = game.hash();
+	int table_action = -1;
+
+	if (table != nullptr) {
+		TranspositionEntry entry;
+
+		if (table->probe(key, entry)) {
+			table_action = entry.best_action;
+
+			if (entry.depth >= depth && entry.best_action >= 0) {
+				bool cutoff = entry.bound == BoundExact
+					|| (entry.bound == BoundLower && entry.value >= beta)
+					|| (entry.bound == BoundUpper && entry.value <= alpha);
+
+				if (cutoff) {
+					best_idx = table_action;
+					return entry.value;
+				}
+			}
+		}
+	}
+
+	ActionBuffer& ply_actions = actions[ply];
+	game.get_possible_actions(game.player_turn, ply_actions);
+	assert(!ply_actions.empty());
+
+	std::vector<OrderedAction>& order = orders[ply];
+	order.clear();
+
+	int alpha_original = alpha;
+	int best_value = -SOLVER_INFINITY;
+	best_idx = -1;
+
+	for (uint32_t i = 0; i < ply_actions.size(); i++) {
+		UndoRecord record = game.apply(ply_actions[i]);
+		bool is_leaf;
+		int value = evaluate_action(game, record, team, is_leaf);
+		game.undo(record);
+
+		if (depth == 1) {
+			// All children are leaves, their static value is final
+			if (value > best_value) {
+				best_value = value;
+				best_idx = i;
+				alpha = std::max(alpha, value);
+
+				if (alpha >= beta) {
+					break;
+				}
+			}
+
+			continue;
+		}
+
+		// The best action of a previous search comes first, the others are ordered by their static value
+		int priority = static_cast<int>(i) == table_action ? std::numeric_limits<int>::max() : value;
+		order.push_back({ priority, value, is_leaf, i });
+	}
+
+	std::stable_sort(order.begin(), order.end(), [](const OrderedAction& a, const OrderedAction& b) {
+		return a.priority > b.priority;
+	});
+
+	// Value of the position after the action within the window, from the perspective of the team
+	auto search_child = [&](int child_alpha, int child_beta) {
+		int child_best_idx;
+
+		if (game.player_turn % 2 == team) {
+			return search(game, depth - 1, ply + 1, child_alpha, child_beta, child_best_idx);
+		} else {
+			return -search(game, depth - 1, ply + 1, -child_beta, -child_alpha, child_best_idx);
+		}
+	};
+
+	for (const OrderedAction& ordered_action : order) {
+		int value = ordered_action.value;
+
+		if (!ordered_action.is_leaf) {
+			UndoRecord record = game.apply(ply_actions[ordered_action.idx]);
+
+			if (best_idx < 0) {
+				value = search_child(alpha, beta);
+			} else {
+				// Principal variation search: the later actions are only expected to be worse, which is tested with a
+				// null window first
+				value = search_child(alpha, alpha + 1);
+
+				if (alpha < value && value < beta) {
+					value = search_child(alpha, beta);
+				}
+			}
+
+			game.undo(record);
+		}
+
+		if (value > best_value) {
+			best_value = value;
+			best_idx = ordered_action.idx;
+
+			if (value > alpha) {
+				alpha = value;
+
+				if (alpha >= beta) {
+					break;
+				}
+			}
+		}
+	}
+
+	if (table != nullptr) {
+		TranspositionEntry entry;
+		entry.value = best_value;
+		entry.depth = std::min(depth, static_cast<int>(std::numeric_limits<int8_t>::max()));
+		entry.best_action = best_idx;
+
+		if (best_value <= alpha_original) {
+			entry.bound = BoundUpper;
+		} else if (best_value >= beta) {
+			entry.bound = BoundLower;
+		} else {
+			entry.bound = BoundExact;
+		}
+
+		table->store(key, entry);
+	}
+
+	return best_value;
+}
+
+}
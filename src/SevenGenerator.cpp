@@ -0,0 +1,362 @@
+#include "SevenGenerator.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <libdog/BoardUtil.hpp>
+
+
+// Initial number of slots of the result set, it doubles whenever it is half full
+#define SEVEN_RESULT_SET_SIZE (1024)
+
+namespace libdog {
+
+// Piece positions of a result, regardless of which piece of a player stands where. Two results with equal outcomes
+// are the same position.
+class SevenOutcome {
+	public:
+		// Cells of the pieces of every player in ascending order
+		std::array<int8_t, PLAYER_COUNT * PIECE_COUNT> cells;
+		// One bit per player with a piece blocking its start
+		uint8_t blocking_players = 0;
+
+		explicit SevenOutcome(const SevenBoard& board) : cells(board.cells) {
+			for (int player = 0; player < PLAYER_COUNT; player++) {
+				auto begin = cells.begin() + player * PIECE_COUNT;
+				std::sort(begin, begin + PIECE_COUNT);
+
+				if ((board.blocking >> (player * PIECE_COUNT)) & ((1 << PIECE_COUNT) - 1)) {
+					blocking_players |= 1 << player;
+				}
+			}
+		}
+
+		friend bool operator==(const SevenOutcome& a, const SevenOutcome& b) = default;
+};
+
+// Open addressing hash set of results. Slots are invalidated by bumping the generation, so clearing the set does not
+// need to touch its memory. The keys only select the slots, results are only equal if their outcomes are, so a Zobrist
+// collision cannot drop a legal seven.
+class SevenResultSet {
+	private:
+		class Entry {
+			public:
+				uint64_t key;
+				SevenOutcome outcome;
+		};
+
+		// Entries of the current generation
+		std::vector<Entry> entries;
+
+		// Index into entries for every slot
+		std::vector<uint32_t> slots;
+		std::vector<uint32_t> generations;
+		uint32_t generation = 1;
+
+		std::size_t find_slot(uint64_t key, const SevenOutcome& outcome, bool& found) const {
+			std::size_t mask = slots.size() - 1;
+			std::size_t i = (key ^ (key >> 32)) & mask;
+
+			while (generations[i] == generation) {
+				const Entry& entry = entries[slots[i]];
+
+				if (entry.key == key && entry.outcome == outcome) {
+					found = true;
+					return i;
+				}
+
+				i = (i + 1) & mask;
+			}
+
+			found = false;
+			return i;
+		}
+
+		void grow() {
+			slots.resize(2 * slots.size());
+			generations.assign(slots.size(), 0);
+			generation = 1;
+
+			for (std::size_t idx = 0; idx < entries.size(); idx++) {
+				bool found;
+				std::size_t i = find_slot(entries[idx].key, entries[idx].outcome, found);
+				assert(!found);
+
+				generations[i] = generation;
+				slots[i] = idx;
+			}
+		}
+
+	public:
+		SevenResultSet() : slots(SEVEN_RESULT_SET_SIZE), generations(SEVEN_RESULT_SET_SIZE, 0) {}
+
+		void clear() {
+			entries.clear();
+			generation++;
+
+			if (generation == 0) {
+				generations.assign(generations.size(), 0);
+				generation = 1;
+			}
+		}
+
+		// Returns false if an equal result is already in the set
+		bool insert(const SevenBoard& result) {
+			SevenOutcome outcome(result);
+
+			bool found;
+			std::size_t i = find_slot(result.key, outcome, found);
+
+			if (found) {
+				return false;
+			}
+
+			generations[i] = generation;
+			slots[i] = entries.size();
+			entries.push_back({ result.key, outcome });
+
+			if (2 * entries.size() >= slots.size()) {
+				grow();
+			}
+
+			return true;
+		}
+};
+
+static thread_local SevenResultSet result_set;
+
+SevenBoard::SevenBoard(const BoardState& board_state) : key(board_state.hash()) {
+	occupants.fill(SEVEN_NO_PIECE);
+	cells.fill(SEVEN_IN_KENNEL);
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		for (int idx = 0; idx < PIECE_COUNT; idx++) {
+			const Piece& piece = board_state.pieces.at(player).at(idx);
+			int piece_idx = player * PIECE_COUNT + idx;
+			int cell = get_zobrist_cell(piece.position);
+
+			if (cell != ZOBRIST_NO_CELL) {
+				occupants[cell] = piece_idx;
+				cells[piece_idx] = cell;
+			}
+
+			if (piece.blocking) {
+				blocking |= 1 << piece_idx;
+			}
+		}
+	}
+}
+
+void SevenBoard::place(int piece, int cell, bool piece_blocking) {
+	int player = piece / PIECE_COUNT;
+
+	assert(occupants[cell] == SEVEN_NO_PIECE);
+	assert(cells[piece] == SEVEN_IN_KENNEL);
+
+	occupants[cell] = piece;
+	cells[piece] = cell;
+	key ^= zobrist_keys.cells[player][cell];
+
+	if (piece_blocking) {
+		blocking |= 1 << piece;
+		key ^= zobrist_keys.blocking[player];
+	}
+}
+
+void SevenBoard::remove(int piece) {
+	int player = piece / PIECE_COUNT;
+	int cell = cells[piece];
+
+	assert(cell != SEVEN_IN_KENNEL);
+
+	occupants[cell] = SEVEN_NO_PIECE;
+	cells[piece] = SEVEN_IN_KENNEL;
+	key ^= zobrist_keys.cells[player][cell];
+
+	if (blocking & (1 << piece)) {
+		blocking &= ~(1 << piece);
+		key ^= zobrist_keys.blocking[player];
+	}
+}
+
+bool SevenBoard::step(int piece, SevenFootprint& footprint) {
+	int player = piece / PIECE_COUNT;
+	int cell = cells[piece];
+
+	if (cell == SEVEN_IN_KENNEL) {
+		return false;
+	}
+
+	if (cell >= PATH_LENGTH) {
+		// Piece is in its finish
+		int finish_idx = cell - get_zobrist_finish_cell(player, 0);
+
+		if (finish_idx + 1 >= FINISH_LENGTH || occupants[cell + 1] != SEVEN_NO_PIECE) {
+			return false;
+		}
+
+		remove(piece);
+		place(piece, cell + 1, false);
+		footprint.add(cell + 1);
+
+		return true;
+	}
+
+	bool piece_blocking = blocking & (1 << piece);
+
+	if (!piece_blocking && calc_steps_to_start(player, cell) == 0) {
+		// Piece is right before its finish and has to enter it if the first finish position is free
+		int finish_cell = get_zobrist_finish_cell(player, 0);
+		footprint.add(finish_cell);
+
+		if (occupants[finish_cell] == SEVEN_NO_PIECE) {
+			remove(piece);
+			place(piece, finish_cell, false);
+
+			return true;
+		}
+	}
+
+	int next_cell = (cell + 1) % PATH_LENGTH;
+	int occupant = occupants[next_cell];
+
+	if (occupant != SEVEN_NO_PIECE) {
+		if (blocking & (1 << occupant)) {
+			return false;
+		}
+
+		// Pieces that are passed by a seven are sent back to their kennel
+		remove(occupant);
+	}
+
+	remove(piece);
+	place(piece, next_cell, false);
+	footprint.add(next_cell);
+
+	return true;
+}
+
+SevenGenerator::SevenGenerator(const BoardState& board_state, int player, bool canadian_rule) : board(board_state) {
+	int team_player = GET_TEAM_PLAYER_IDX(player);
+
+	for (int mover_player : { player, team_player }) {
+		if (mover_player == team_player && !canadian_rule) {
+			break;
+		}
+
+		for (int rank = 0; rank < PIECE_COUNT; rank++) {
+			PiecePtr piece = board_state.ref_to_piece(PieceRef(mover_player, rank));
+			assert(piece != nullptr);
+
+			if (piece->position.area == Kennel) {
+				continue;
+			}
+
+			if (!RULE_ALLOW_SEVEN_MOVE_TEAMMATE_IF_BLOCKED) {
+				if (mover_player != player && piece->blocking) {
+					continue;
+				}
+			}
+
+			movers[mover_count] = { piece->player * PIECE_COUNT + piece->idx, mover_player, rank };
+			mover_count++;
+		}
+	}
+}
+
+std::size_t SevenGenerator::generate(Card card, int count, bool is_joker, ActionBuffer& out, std::size_t max_results) {
+	this->card = card;
+	this->is_joker = is_joker;
+	this->out = &out;
+	this->max_results = max_results;
+	result_count = 0;
+	move_specifiers.clear();
+
+	if (mover_count == 0) {
+		return 0;
+	}
+
+	result_set.clear();
+
+	search(board, count, -1, SevenFootprint(), 0);
+
+	return result_count;
+}
+
+bool SevenGenerator::exists(int count) {
+	out = nullptr;
+	max_results = 1;
+	result_count = 0;
+	move_specifiers.clear();
+
+	if (mover_count == 0) {
+		return false;
+	}
+
+	result_set.clear();
+
+	search(board, count, -1, SevenFootprint(), 0);
+
+	return result_count > 0;
+}
+
+bool SevenGenerator::search(const SevenBoard& current, int remaining, int last_mover, const SevenFootprint& last_footprint, unsigned used) {
+	if (remaining == 0) {
+		return emit(current);
+	}
+
+	for (int i = 0; i < mover_count; i++) {
+		if (used & (1 << i)) {
+			continue;
+		}
+
+		const Mover& mover = movers[i];
+
+		if (current.cells[mover.piece] == SEVEN_IN_KENNEL) {
+			// Piece was sent back to its kennel by one of the previous moves
+			continue;
+		}
+
+		SevenBoard next = current;
+		SevenFootprint footprint;
+		footprint.add(current.cells[mover.piece]);
+
+		for (int count = 1; count <= remaining; count++) {
+			if (!next.step(mover.piece, footprint)) {
+				// All larger counts include this step as well
+				break;
+			}
+
+			// The same outcome is reached by moving this piece before the previous one
+			if (i < last_mover && footprint.is_disjoint(last_footprint)) {
+				continue;
+			}
+
+			move_specifiers.push_back(MoveSpecifier(PieceRef(mover.player, mover.rank), count, false));
+			bool proceed = search(next, remaining - count, i, footprint, used | (1 << i));
+			move_specifiers.pop_back();
+
+			if (!proceed) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool SevenGenerator::emit(const SevenBoard& result) {
+	if (!result_set.insert(result)) {
+		return true;
+	}
+
+	if (out != nullptr) {
+		out->push_back(MoveMultiple(card, move_specifiers, is_joker));
+	}
+
+	result_count++;
+
+	return max_results == 0 || result_count < max_results;
+}
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <libdog/BoardState.hpp>
+#include <libdog/ActionBuffer.hpp>
+#include <libdog/Action.hpp>
+#include <libdog/Card.hpp>
+#include <libdog/Constants.hpp>
+#include <libdog/Zobrist.hpp>
+
+
+#define SEVEN_MAX_MOVERS (2 * PIECE_COUNT)
+
+#define SEVEN_NO_PIECE (-1)
+#define SEVEN_IN_KENNEL (ZOBRIST_NO_CELL)
+
+namespace libdog {
+
+// Cells of the board that were read or written by the move of a single piece
+class SevenFootprint {
+	private:
+		uint64_t path = 0;
+		uint16_t finishes = 0;
+
+	public:
+		void add(int cell) {
+			if (cell < PATH_LENGTH) {
+				path |= UINT64_C(1) << cell;
+			} else {
+				finishes |= 1 << (cell - PATH_LENGTH);
+			}
+		}
+
+		bool is_disjoint(const SevenFootprint& other) const {
+			return (path & other.path) == 0 && (finishes & other.finishes) == 0;
+		}
+};
+
+// Compact copy of the piece positions that is sufficient to simulate the single steps of a seven. Cells are numbered
+// as in Zobrist.hpp.
+class SevenBoard {
+	public:
+		// Piece index (player * PIECE_COUNT + idx) for every cell or SEVEN_NO_PIECE
+		std::array<int8_t, ZOBRIST_CELL_COUNT> occupants;
+		// Cell of every piece or SEVEN_IN_KENNEL
+		std::array<int8_t, PLAYER_COUNT * PIECE_COUNT> cells;
+		// One bit per piece index
+		uint16_t blocking = 0;
+		// Same as BoardState::hash() for the simulated position
+		uint64_t key = 0;
+
+		explicit SevenBoard(const BoardState& board_state);
+
+		// Moves the piece one step forward with the same semantics as BoardState::move_piece() (without avoid_finish),
+		// returns false if the step is not possible
+		bool step(int piece, SevenFootprint& footprint);
+
+	private:
+		void place(int piece, int cell, bool piece_blocking);
+
+		void remove(int piece);
+};
+
+// Enumerates all distinct outcomes of splitting a seven among the pieces of a player (and its teammate). The board
+// state is only read during construction, the search itself runs on a SevenBoard.
+//
+// Instead of every ordering of single steps, the generator enumerates sequences of (piece, count) moves in which every
+// piece appears at most once. Two adjacent moves whose footprints are disjoint commute, so only the ordering in which
+// the lower mover comes first is searched. Outcomes that are still reached more than once are filtered.
+class SevenGenerator {
+	public:
+		SevenGenerator(const BoardState& board_state, int player, bool canadian_rule);
+
+		// Appends one MoveMultiple per distinct resulting position to out. If max_results is not zero, the search stops
+		// after that many actions. Returns the number of appended actions.
+		std::size_t generate(Card card, int count, bool is_joker, ActionBuffer& out, std::size_t max_results = 0);
+
+		// Returns true if there is at least one legal split, stops at the first one that is found
+		bool exists(int count);
+
+	private:
+		class Mover {
+			public:
+				int piece;
+				int player;
+				int rank;
+		};
+
+		SevenBoard board;
+
+		std::array<Mover, SEVEN_MAX_MOVERS> movers;
+		int mover_count = 0;
+
+		// State of the current search
+		Card card = Seven;
+		bool is_joker = false;
+		ActionBuffer* out = nullptr;
+		std::size_t max_results = 0;
+		std::size_t result_count = 0;
+		MoveSpecifiers move_specifiers;
+
+		// Returns false if the search shall stop
+		bool search(const SevenBoard& current, int remaining, int last_mover, const SevenFootprint& last_footprint, unsigned used);
+
+		bool emit(const SevenBoard& result);
+};
+
+}
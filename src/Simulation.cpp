@@ -0,0 +1,124 @@
+#include <libdog/Simulation.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+// Number of games a worker claims at once, small enough to balance the load at the end of a simulation
+#define SIMULATION_CHUNK_SIZE (16)
+
+namespace libdog {
+
+void SimulationStats::add(const PlayoutResult& result) {
+	if (game_count == 0 || result.move_count < min_game_length) {
+		min_game_length = result.move_count;
+	}
+
+	if (game_count == 0 || result.move_count > max_game_length) {
+		max_game_length = result.move_count;
+	}
+
+	game_count++;
+
+	if (result.winner >= 0) {
+		wins.at(result.winner)++;
+	}
+
+	move_count += result.move_count;
+	action_count += result.action_count;
+}
+
+SimulationStats& SimulationStats::operator+=(const SimulationStats& other) {
+	if (other.game_count == 0) {
+		return *this;
+	}
+
+	if (game_count == 0) {
+		*this = other;
+		return *this;
+	}
+
+	game_count += other.game_count;
+
+	for (std::size_t i = 0; i < wins.size(); i++) {
+		wins[i] += other.wins[i];
+	}
+
+	move_count += other.move_count;
+	action_count += other.action_count;
+	min_game_length = std::min(min_game_length, other.min_game_length);
+	max_game_length = std::max(max_game_length, other.max_game_length);
+
+	return *this;
+}
+
+double SimulationStats::get_win_rate(int team) const {
+	return game_count == 0 ? 0.0 : static_cast<double>(wins.at(team)) / game_count;
+}
+
+double SimulationStats::get_mean_game_length() const {
+	return game_count == 0 ? 0.0 : static_cast<double>(move_count) / game_count;
+}
+
+double SimulationStats::get_mean_actions_per_move() const {
+	return move_count == 0 ? 0.0 : static_cast<double>(action_count) / move_count;
+}
+
+uint64_t get_game_seed(uint64_t seed, uint64_t game_idx) {
+	uint64_t state = seed ^ splitmix64(game_idx);
+	return splitmix64(state);
+}
+
+static void run_worker(const SimulationConfig& config, std::atomic<uint64_t>& next_game, SimulationStats& stats) {
+	Playout playout(config.policy, 0, config.max_moves);
+	DogGame game(true);
+
+	while (true) {
+		uint64_t first = next_game.fetch_add(SIMULATION_CHUNK_SIZE, std::memory_order_relaxed);
+
+		if (first >= config.game_count) {
+			break;
+		}
+
+		uint64_t last = std::min(first + SIMULATION_CHUNK_SIZE, config.game_count);
+
+		for (uint64_t game_idx = first; game_idx < last; game_idx++) {
+			uint64_t game_seed = get_game_seed(config.seed, game_idx);
+
+			game.reset_with_seed(game_seed);
+			// Different stream than the one used for shuffling the cards
+			playout.get_rng().seed_with(~game_seed);
+
+			stats.add(playout.run(game));
+		}
+	}
+}
+
+SimulationStats simulate(const SimulationConfig& config) {
+	unsigned thread_count = config.thread_count;
+
+	if (thread_count == 0) {
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	std::atomic<uint64_t> next_game = 0;
+	std::vector<SimulationStats> worker_stats(thread_count);
+	std::vector<std::thread> threads;
+
+	for (unsigned i = 0; i < thread_count; i++) {
+		threads.emplace_back(run_worker, std::cref(config), std::ref(next_game), std::ref(worker_stats[i]));
+	}
+
+	SimulationStats result;
+
+	for (unsigned i = 0; i < thread_count; i++) {
+		threads[i].join();
+		result += worker_stats[i];
+	}
+
+	return result;
+}
+
+}
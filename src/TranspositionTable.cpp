@@ -0,0 +1,93 @@
+#include <libdog/TranspositionTable.hpp>
+
+#include <cassert>
+#include <climits>
+
+
+namespace libdog {
+
+TranspositionTable::TranspositionTable(std::size_t size_bytes) {
+	std::size_t bucket_count = 1;
+
+	while (2 * bucket_count * sizeof(Bucket) <= size_bytes) {
+		bucket_count *= 2;
+	}
+
+	buckets = std::vector<Bucket>(bucket_count);
+	mask = bucket_count - 1;
+}
+
+uint64_t TranspositionTable::pack(const TranspositionEntry& entry) {
+	assert(entry.bound != 0);
+
+	return static_cast<uint64_t>(static_cast<uint32_t>(entry.value))
+		| static_cast<uint64_t>(static_cast<uint8_t>(entry.depth)) << 32
+		| static_cast<uint64_t>(entry.bound) << 40
+		| static_cast<uint64_t>(static_cast<uint16_t>(entry.best_action)) << 48;
+}
+
+TranspositionEntry TranspositionTable::unpack(uint64_t data) {
+	TranspositionEntry result;
+	result.value = static_cast<int32_t>(static_cast<uint32_t>(data));
+	result.depth = static_cast<int8_t>(static_cast<uint8_t>(data >> 32));
+	result.bound = static_cast<TranspositionBound>(static_cast<uint8_t>(data >> 40));
+	result.best_action = static_cast<int16_t>(static_cast<uint16_t>(data >> 48));
+	return result;
+}
+
+bool TranspositionTable::probe(uint64_t key, TranspositionEntry& result) const {
+	const Bucket& bucket = get_bucket(key);
+
+	for (const Slot& slot : bucket.slots) {
+		uint64_t data = slot.data.load(std::memory_order_relaxed);
+		uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+		if (data != 0 && (check ^ data) == key) {
+			result = unpack(data);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void TranspositionTable::store(uint64_t key, const TranspositionEntry& entry) {
+	Bucket& bucket = get_bucket(key);
+	Slot* replace = nullptr;
+	int replace_depth = 0;
+
+	// The whole bucket is searched for the key first, an empty slot in front of it would otherwise lead to two entries
+	// of the same key
+	for (Slot& slot : bucket.slots) {
+		uint64_t data = slot.data.load(std::memory_order_relaxed);
+		uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+		if (data != 0 && (check ^ data) == key) {
+			replace = &slot;
+			break;
+		}
+
+		// Empty slots are preferred over the one with the lowest depth
+		int depth = (data == 0) ? INT_MIN : unpack(data).depth;
+
+		if (replace == nullptr || depth < replace_depth) {
+			replace = &slot;
+			replace_depth = depth;
+		}
+	}
+
+	uint64_t data = pack(entry);
+	replace->data.store(data, std::memory_order_relaxed);
+	replace->check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+	for (Bucket& bucket : buckets) {
+		for (Slot& slot : bucket.slots) {
+			slot.data.store(0, std::memory_order_relaxed);
+			slot.check.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+}
@@ -2,12 +2,23 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 
 inline int positive_mod(int i, int n) {
 	return ((i % n) + n) % n;
 }
 
+// Reverse the order of the bits of a 64-bit integer
+inline uint64_t reverse_bits(uint64_t x) {
+	x = ((x >> 1) & UINT64_C(0x5555555555555555)) | ((x & UINT64_C(0x5555555555555555)) << 1);
+	x = ((x >> 2) & UINT64_C(0x3333333333333333)) | ((x & UINT64_C(0x3333333333333333)) << 2);
+	x = ((x >> 4) & UINT64_C(0x0F0F0F0F0F0F0F0F)) | ((x & UINT64_C(0x0F0F0F0F0F0F0F0F)) << 4);
+	x = ((x >> 8) & UINT64_C(0x00FF00FF00FF00FF)) | ((x & UINT64_C(0x00FF00FF00FF00FF)) << 8);
+	x = ((x >> 16) & UINT64_C(0x0000FFFF0000FFFF)) | ((x & UINT64_C(0x0000FFFF0000FFFF)) << 16);
+	return (x >> 32) | (x << 32);
+}
+
 // Remove all duplicates from a vector
 template<typename T>
 inline void remove_duplicates(std::vector<T>& v) {
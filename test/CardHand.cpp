@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <libdog/libdog.hpp>
+
+
+using namespace libdog;
+
+TEST(CardHand, AddRemove) {
+	CardHand hand(cards_from_str("7AX7J"));
+
+	EXPECT_EQ(hand.size(), 5);
+	EXPECT_TRUE(hand.contains(Seven));
+	EXPECT_FALSE(hand.contains(Two));
+	EXPECT_EQ(hand.count(Seven), 2);
+	EXPECT_EQ(hand.count(Ace), 1);
+	EXPECT_EQ(hand.get_cards(), cards_from_str("A77JX"));
+	EXPECT_EQ(hand.to_str(), "A77JX");
+
+	hand.remove(Seven);
+	EXPECT_TRUE(hand.contains(Seven));
+	EXPECT_EQ(hand.count(Seven), 1);
+
+	hand.remove(Seven);
+	EXPECT_FALSE(hand.contains(Seven));
+	EXPECT_EQ(hand.size(), 3);
+
+	// The order in which the cards were added does not matter
+	EXPECT_EQ(hand, CardHand(cards_from_str("JAX")));
+	EXPECT_FALSE(hand == CardHand(cards_from_str("JA")));
+}
+
+TEST(CardHand, CardMask) {
+	CardHand hand;
+	EXPECT_EQ(hand.get_card_mask(), 0);
+	EXPECT_TRUE(hand.empty());
+
+	for (Card card : get_dog_card_set()) {
+		hand.add(card);
+	}
+
+	EXPECT_EQ(hand.size(), get_dog_card_set().size());
+	EXPECT_EQ(hand.count(Ace), 4 * DECK_COUNT);
+	EXPECT_EQ(hand.count(Joker), JOKER_COUNT);
+
+	std::vector<Card> distinct;
+
+	for (uint16_t mask = hand.get_card_mask(); mask != 0; mask &= mask - 1) {
+		distinct.push_back(static_cast<Card>(std::countr_zero(mask)));
+	}
+
+	EXPECT_EQ(distinct, cards_from_str("A23456789TJQKX"));
+}
+
+TEST(CardHand, MoveTo) {
+	CardHand source(cards_from_str("22K"));
+	CardHand dest(cards_from_str("2A"));
+
+	source.move_to(dest);
+
+	EXPECT_TRUE(source.empty());
+	EXPECT_EQ(source.get_card_mask(), 0);
+	EXPECT_EQ(dest, CardHand(cards_from_str("A222K")));
+	EXPECT_EQ(dest.size(), 5);
+
+	Card cards[5];
+	EXPECT_EQ(dest.take_all(cards), cards + 5);
+	EXPECT_TRUE(dest.empty());
+	EXPECT_THAT(cards, testing::ElementsAre(Ace, Two, Two, Two, King));
+}
+
+TEST(CardStack, DealTo) {
+	CardStack deck(cards_from_str("A23456"));
+	CardHand hand;
+
+	deck.deal_to(hand, 4);
+	EXPECT_EQ(hand, CardHand(cards_from_str("A234")));
+	EXPECT_EQ(deck.size(), 2);
+	EXPECT_EQ(deck.get_cards(), cards_from_str("56"));
+	EXPECT_EQ(deck, CardStack(cards_from_str("56")));
+
+	deck.deal_to(hand, 2);
+	EXPECT_TRUE(deck.empty());
+	EXPECT_EQ(hand.size(), 6);
+}
+
+TEST(CardStack, HandOutWraps) {
+	CardsState cards_state(cards_from_str("A23456789T"));
+	cards_state.hand_out_cards(2);
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		for (Card card : cards_state.get_hand_cards(player)) {
+			cards_state.discard(player, card);
+		}
+	}
+
+	// The first player gets the rest of the deck, then the discarded cards are shuffled back in
+	cards_state.hand_out_cards(2);
+	EXPECT_EQ(cards_state.get_hand_cards(0), cards_from_str("9T"));
+	EXPECT_EQ(cards_state.get_deck().size(), 2);
+
+	std::vector<Card> cards = cards_state.get_deck().get_cards();
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		std::vector<Card> hand = cards_state.get_hand_cards(player);
+		EXPECT_EQ(hand.size(), 2);
+		cards.insert(cards.end(), hand.begin(), hand.end());
+	}
+
+	std::sort(cards.begin(), cards.end());
+	EXPECT_EQ(cards, cards_from_str("A23456789T"));
+}
+
+TEST(CardStack, HandOutTooFew) {
+	CardsState cards_state(cards_from_str("A23456"));
+	EXPECT_THROW(cards_state.hand_out_cards(2), std::length_error);
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+#include <libdog/libdog.hpp>
+
+
+using namespace libdog;
+
+static const FinishTablebase& get_tablebase() {
+	static FinishTablebase tablebase = FinishTablebase::generate();
+	return tablebase;
+}
+
+static double probe(const std::string& board_str) {
+	DogGame game(true, false, false, false);
+	game.load_board(board_str);
+
+	double result = -1;
+	EXPECT_TRUE(get_tablebase().probe(game.board_state, 0, result));
+
+	return result;
+}
+
+TEST(FinishTablebase, PerfectHash) {
+	int region = FINISH_TABLEBASE_DEFAULT_REGION;
+	int cell_count = region + 1 + FINISH_LENGTH;
+	std::set<uint32_t> indices;
+
+	for (int a = 0; a < cell_count; a++) {
+		for (int b = a + 1; b < cell_count; b++) {
+			for (int c = b + 1; c < cell_count; c++) {
+				for (int d = c + 1; d < cell_count; d++) {
+					uint32_t idx = FinishTablebase::get_index({ c, a, d, b });
+					EXPECT_LT(idx, FinishTablebase::get_position_count(region));
+					indices.insert(idx);
+				}
+			}
+		}
+	}
+
+	EXPECT_EQ(indices.size(), FinishTablebase::get_position_count(region));
+	EXPECT_EQ(get_tablebase().size(), FinishTablebase::get_position_count(region));
+}
+
+TEST(FinishTablebase, Values) {
+	EXPECT_EQ(probe("F0F1F2F3|||"), 0);
+
+	// The last piece is on the start. Only an ace or a joker finish, a four has to be played backwards.
+	double on_start = probe("P0F1F2F3|||");
+	double four_behind = probe("P60F1F2F3|||");
+
+	double ace = 8.0 / 110;
+	double four = 8.0 / 110;
+	double joker = 6.0 / 110;
+	double stay = 1 - ace - four - joker;
+
+	EXPECT_NEAR(on_start, (1 + four * four_behind) / (1 - stay), 0.01);
+	EXPECT_GT(on_start, 1);
+
+	// More pieces outside of the finish need more turns
+	EXPECT_LT(probe("P60F1F2F3|||"), probe("P53P54P55P56|||"));
+
+	// Closer is not always better: two steps before the start, most cards cannot be played or force the piece away
+	EXPECT_GT(probe("P62F0F1F2|||"), probe("P56F0F1F2|||"));
+
+	// Pieces of other players are not part of the table
+	EXPECT_EQ(probe("P60F1F2F3|P20||"), four_behind);
+}
+
+TEST(FinishTablebase, OutsideOfTable) {
+	DogGame game(true, false, false, false);
+	double result;
+
+	game.load_board("P30F1F2F3|||");
+	EXPECT_FALSE(get_tablebase().probe(game.board_state, 0, result));
+
+	game.load_board("F1F2F3|||");
+	EXPECT_FALSE(get_tablebase().probe(game.board_state, 0, result));
+
+	game.load_board("P0*F1F2F3|||");
+	EXPECT_FALSE(get_tablebase().probe(game.board_state, 0, result));
+
+	// Other players are counted from their own start
+	game.load_board("|P14F1F2F3||");
+	EXPECT_TRUE(get_tablebase().probe(game.board_state, 1, result));
+	EXPECT_EQ(result, probe("P62F1F2F3|||"));
+}
+
+TEST(FinishTablebase, SaveLoad) {
+	std::string path = testing::TempDir() + "finish_tablebase.bin";
+	ASSERT_TRUE(get_tablebase().save(path));
+
+	FinishTablebase loaded;
+	ASSERT_TRUE(loaded.load(path));
+	EXPECT_EQ(loaded.get_region(), get_tablebase().get_region());
+	ASSERT_EQ(loaded.size(), get_tablebase().size());
+
+	for (uint32_t idx = 0; idx < loaded.size(); idx++) {
+		EXPECT_EQ(loaded.get_value(idx), get_tablebase().get_value(idx));
+	}
+
+	// Moving keeps the mapping alive
+	FinishTablebase moved = std::move(loaded);
+	DogGame game(true, false, false, false);
+	game.load_board("P60F1F2F3|||");
+	double result;
+	EXPECT_TRUE(moved.probe(game.board_state, 0, result));
+	EXPECT_EQ(result, probe("P60F1F2F3|||"));
+
+	// Truncated files are rejected
+	std::ofstream(path, std::ios::binary) << "DFTB";
+	FinishTablebase invalid;
+	EXPECT_FALSE(invalid.load(path));
+	EXPECT_FALSE(invalid.load(path + ".missing"));
+
+	std::remove(path.c_str());
+}
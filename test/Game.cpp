@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <cstring>
+
 #include <libdog/libdog.hpp>
 
 
@@ -10,13 +12,13 @@ using namespace libdog;
 
 
 #define EXPECT_PLAYER_AT(path_idx, player_id) do { \
-	EXPECT_NE(game.board_state.path.at(path_idx), nullptr); \
-	EXPECT_EQ(game.board_state.path.at(path_idx)->player, player_id); \
+	EXPECT_NE(game.board_state.get_piece(path_idx), nullptr); \
+	EXPECT_EQ(game.board_state.get_piece(path_idx)->player, player_id); \
 } while(0)
 
 #define EXPECT_PLAYER_AT_FINISH(finish_idx, player_id) do { \
-	EXPECT_NE(game.board_state.finishes.at(player).at(finish_idx), nullptr); \
-	EXPECT_EQ(game.board_state.finishes.at(player).at(finish_idx)->player, player_id); \
+	EXPECT_NE(game.board_state.get_piece(BoardPosition(Finish, player, finish_idx)), nullptr); \
+	EXPECT_EQ(game.board_state.get_piece(BoardPosition(Finish, player, finish_idx))->player, player_id); \
 } while(0)
 
 #define TEST_MOVE_FROM_TO(notation_start, player_id, notation_move, notation_end) do { \
@@ -60,11 +62,13 @@ using namespace libdog;
 	CHECK_POSSIBLE_ACTIONS(player_id, game_var_name, actions_var_name, state_results_expected); \
 } while(0)
 
-#define TEST_UNDO_STACK(game_var_name, notation_start, player_id) do { \
+#define TEST_JOURNAL(game_var_name, notation_start, player_id, action_notation) do { \
 	game_var_name.load_board(notation_start); \
-	EXPECT_TRUE(game_var_name.play_notation(player_id, "A'0")); \
+	Journal journal; \
+	std::size_t mark = game_var_name.board_state.begin_journal(journal); \
+	EXPECT_TRUE(game_var_name.play_notation(player_id, action_notation)); \
 	EXPECT_TRUE(game.board_state.check_state()); \
-	game_var_name.board_state.undo_one_step(); \
+	game_var_name.board_state.rollback_journal(mark); \
 	EXPECT_TRUE(game.board_state.check_state()); \
 	EXPECT_EQ(to_notation(game_var_name.board_state), notation_start); \
 } while(0);
@@ -77,21 +81,21 @@ TEST(BasicTest, Reset) {
 
 	for (std::size_t player = 0; player != game.board_state.kennels.size(); player++) {
 		for (std::size_t j = 0; j != game.board_state.kennels.size(); j++) {
-			PiecePtr& piece = game.board_state.kennels.at(player).at(j);
+			PiecePtr piece = game.board_state.get_piece(BoardPosition(Kennel, player, j));
 
 			EXPECT_NE(piece, nullptr);
 		}
 	}
 
 	for (std::size_t i = 0; i != game.board_state.path.size(); i++) {
-		PiecePtr& piece = game.board_state.path.at(i);
+		PiecePtr piece = game.board_state.get_piece(i);
 
 		EXPECT_EQ(piece, nullptr);
 	}
 
 	for (std::size_t player = 0; player != game.board_state.finishes.size(); player++) {
 		for (std::size_t j = 0; j != game.board_state.finishes.size(); j++) {
-			PiecePtr& piece = game.board_state.finishes.at(player).at(j);
+			PiecePtr piece = game.board_state.get_piece(BoardPosition(Finish, player, j));
 
 			EXPECT_EQ(piece, nullptr);
 		}
@@ -104,22 +108,22 @@ TEST(BasicTest, Start) {
 	game.board_state.start_piece(0, true);
 	EXPECT_TRUE(game.board_state.check_state());
 	EXPECT_PLAYER_AT(0, 0);
-	EXPECT_EQ(game.board_state.path.at(0)->blocking, true);
+	EXPECT_EQ(game.board_state.get_piece(0)->blocking, true);
 
 	game.board_state.start_piece(1, true);
 	EXPECT_TRUE(game.board_state.check_state());
 	EXPECT_PLAYER_AT(16, 1);
-	EXPECT_EQ(game.board_state.path.at(16)->blocking, true);
+	EXPECT_EQ(game.board_state.get_piece(16)->blocking, true);
 
 	game.board_state.start_piece(2, true);
 	EXPECT_TRUE(game.board_state.check_state());
 	EXPECT_PLAYER_AT(32, 2);
-	EXPECT_EQ(game.board_state.path.at(32)->blocking, true);
+	EXPECT_EQ(game.board_state.get_piece(32)->blocking, true);
 
 	game.board_state.start_piece(3, true);
 	EXPECT_TRUE(game.board_state.check_state());
 	EXPECT_PLAYER_AT(48, 3);
-	EXPECT_EQ(game.board_state.path.at(48)->blocking, true);
+	EXPECT_EQ(game.board_state.get_piece(48)->blocking, true);
 }
 
 TEST(BasicTest, MovePiece) {
@@ -137,7 +141,7 @@ TEST(BasicTest, MovePiece) {
 		EXPECT_TRUE(game.board_state.check_state());
 	}
 
-	EXPECT_NE(game.board_state.path.at(0), nullptr);
+	EXPECT_NE(game.board_state.get_piece(0), nullptr);
 }
 
 TEST(BasicTest, Blockades) {
@@ -150,22 +154,22 @@ TEST(BasicTest, Blockades) {
 	legal = game.board_state.move_piece(game.board_state.get_piece(BoardPosition(0)), PATH_SECTION_LENGTH, true, true, false);
 	EXPECT_TRUE(legal);
 	EXPECT_TRUE(game.board_state.check_state());
-	EXPECT_NE(game.board_state.path.at(PATH_SECTION_LENGTH), nullptr);
+	EXPECT_NE(game.board_state.get_piece(PATH_SECTION_LENGTH), nullptr);
 
 	legal = game.board_state.move_piece(game.board_state.get_piece(BoardPosition(PATH_SECTION_LENGTH)), -PATH_SECTION_LENGTH, true, true, false);
 	EXPECT_TRUE(legal);
 	EXPECT_TRUE(game.board_state.check_state());
-	EXPECT_NE(game.board_state.path.at(0), nullptr);
+	EXPECT_NE(game.board_state.get_piece(0), nullptr);
 
 	legal = game.board_state.move_piece(game.board_state.get_piece(BoardPosition(0)), -PATH_SECTION_LENGTH, true, true, false);
 	EXPECT_TRUE(legal);
 	EXPECT_TRUE(game.board_state.check_state());
-	EXPECT_NE(game.board_state.path.at(PATH_LENGTH - PATH_SECTION_LENGTH), nullptr);
+	EXPECT_NE(game.board_state.get_piece(PATH_LENGTH - PATH_SECTION_LENGTH), nullptr);
 
 	legal = game.board_state.move_piece(game.board_state.get_piece(BoardPosition(PATH_LENGTH - PATH_SECTION_LENGTH)), PATH_SECTION_LENGTH, true, true, false);
 	EXPECT_TRUE(legal);
 	EXPECT_TRUE(game.board_state.check_state());
-	EXPECT_NE(game.board_state.path.at(0), nullptr);
+	EXPECT_NE(game.board_state.get_piece(0), nullptr);
 
 	game.board_state.start_piece(1, true);
 	game.board_state.start_piece(2, true);
@@ -174,42 +178,42 @@ TEST(BasicTest, Blockades) {
 	legal = game.board_state.move_piece(game.board_state.get_piece(BoardPosition(0)), PATH_SECTION_LENGTH, true, true, false);
 	EXPECT_FALSE(legal);
 	EXPECT_TRUE(game.board_state.check_state());
-	EXPECT_NE(game.board_state.path.at(0), nullptr);
+	EXPECT_NE(game.board_state.get_piece(0), nullptr);
 
 	legal = game.board_state.move_piece(game.board_state.get_piece(BoardPosition(0)), -PATH_SECTION_LENGTH, true, true, false);
 	EXPECT_FALSE(legal);
 	EXPECT_TRUE(game.board_state.check_state());
-	EXPECT_NE(game.board_state.path.at(0), nullptr);
+	EXPECT_NE(game.board_state.get_piece(0), nullptr);
 
 	legal = game.board_state.move_piece(game.board_state.get_piece(BoardPosition(0)), PATH_SECTION_LENGTH - 1, true, true, false);
 	EXPECT_TRUE(legal);
 	EXPECT_TRUE(game.board_state.check_state());
-	EXPECT_NE(game.board_state.path.at(PATH_SECTION_LENGTH), nullptr);
+	EXPECT_NE(game.board_state.get_piece(PATH_SECTION_LENGTH), nullptr);
 
 	legal = game.board_state.move_piece(game.board_state.get_piece(BoardPosition(PATH_SECTION_LENGTH - 1)), 1, true, true, false);
 	EXPECT_FALSE(legal);
 	EXPECT_TRUE(game.board_state.check_state());
-	EXPECT_NE(game.board_state.path.at(PATH_SECTION_LENGTH), nullptr);
+	EXPECT_NE(game.board_state.get_piece(PATH_SECTION_LENGTH), nullptr);
 
 	legal = game.board_state.move_piece(game.board_state.get_piece(BoardPosition(PATH_SECTION_LENGTH - 1)), -(PATH_SECTION_LENGTH - 1), true, true, false);
 	EXPECT_TRUE(legal);
 	EXPECT_TRUE(game.board_state.check_state());
-	EXPECT_NE(game.board_state.path.at(0), nullptr);
+	EXPECT_NE(game.board_state.get_piece(0), nullptr);
 
 	legal = game.board_state.move_piece(game.board_state.get_piece(BoardPosition(0)), -(PATH_SECTION_LENGTH - 1), true, true, false);
 	EXPECT_TRUE(legal);
 	EXPECT_TRUE(game.board_state.check_state());
-	EXPECT_NE(game.board_state.path.at(PATH_LENGTH - PATH_SECTION_LENGTH), nullptr);
+	EXPECT_NE(game.board_state.get_piece(PATH_LENGTH - PATH_SECTION_LENGTH), nullptr);
 
 	legal = game.board_state.move_piece(game.board_state.get_piece(BoardPosition(PATH_LENGTH - (PATH_SECTION_LENGTH - 1))), -1, true, true, false);
 	EXPECT_FALSE(legal);
 	EXPECT_TRUE(game.board_state.check_state());
-	EXPECT_NE(game.board_state.path.at(PATH_LENGTH - PATH_SECTION_LENGTH), nullptr);
+	EXPECT_NE(game.board_state.get_piece(PATH_LENGTH - PATH_SECTION_LENGTH), nullptr);
 
 	legal = game.board_state.move_piece(game.board_state.get_piece(BoardPosition(PATH_LENGTH - (PATH_SECTION_LENGTH - 1))), PATH_SECTION_LENGTH - 1, true, true, false);
 	EXPECT_TRUE(legal);
 	EXPECT_TRUE(game.board_state.check_state());
-	EXPECT_NE(game.board_state.path.at(0), nullptr);
+	EXPECT_NE(game.board_state.get_piece(0), nullptr);
 }
 
 TEST(BasicTest, PieceRefResolution) {
@@ -236,7 +240,7 @@ TEST(BasicTest, PieceRefResolution) {
 	EXPECT_EQ(game.board_state.ref_to_pos(PieceRef(player, 2)), pos1);
 	EXPECT_EQ(game.board_state.ref_to_pos(PieceRef(player, 3)), pos2);
 
-	game.board_state.get_piece(pos3)->blocking = true;
+	game.board_state.set_blocking(game.board_state.get_piece(pos3), true);
 
 	EXPECT_EQ(game.board_state.ref_to_pos(PieceRef(player, 0)), pos0);
 	EXPECT_EQ(game.board_state.ref_to_pos(PieceRef(player, 1)), pos1);
@@ -533,6 +537,54 @@ TEST(PossibleAction, Move) {
 	EXPECT_THAT(actions, testing::Contains(from_notation(0, "90")));
 }
 
+TEST(PossibleAction, Buffer) {
+	DogGame game(true, false, false, false);
+	ActionBuffer buffer;
+
+	game.load_board("P60|P17|P34|P50");
+
+	game.possible_actions_for_card(0, Four, false, buffer);
+	EXPECT_EQ(buffer.size(), 2);
+	EXPECT_THAT(buffer, testing::Contains(from_notation(0, "40")));
+	EXPECT_THAT(buffer, testing::Contains(from_notation(0, "4'0")));
+
+	// Actions are appended
+	game.possible_actions_for_card(0, Nine, false, buffer);
+	EXPECT_EQ(buffer.size(), 3);
+	EXPECT_THAT(buffer, testing::Contains(from_notation(0, "90")));
+
+	buffer.clear();
+	EXPECT_TRUE(buffer.empty());
+
+	// Slots of a previous generation are not accessible any more
+	EXPECT_THROW(buffer.at(0), std::out_of_range);
+
+	game.possible_actions_for_card(0, Seven, false, buffer);
+	std::vector<ActionVar> actions = game.possible_actions_for_card(0, Seven, false);
+	EXPECT_THAT(buffer, testing::ElementsAreArray(actions));
+}
+
+TEST(PossibleAction, JokerWithHandCards) {
+	DogGame game(true, false, false, false);
+	game.reset_with_deck("X7A47K2345689TQJ2345689T");
+	game.load_board("P0P5P60|P17P20|P34*|P50");
+	game.give_phase_done = true;
+
+	// The actions of the joker are generated from the ones of the seven, ace, four and king in the hand, they have to
+	// be the same as if they were generated for the joker on its own
+	std::vector<ActionVar> expected;
+
+	for (Card card : { Ace, Four, Seven, King, Joker }) {
+		std::vector<ActionVar> card_actions = game.possible_actions_for_card(0, card, false);
+		expected.insert(expected.end(), card_actions.begin(), card_actions.end());
+	}
+
+	std::vector<ActionVar> actions = game.get_possible_actions(0);
+	EXPECT_THAT(actions, testing::ElementsAreArray(expected));
+	EXPECT_THAT(actions, testing::Contains(from_notation(0, "X40")));
+	EXPECT_THAT(actions, testing::Contains(from_notation(0, "40")));
+}
+
 TEST(PossibleAction, MoveInFinish) {
 	DogGame game(true, false, false, false);
 	std::vector<ActionVar> actions;
@@ -751,6 +803,123 @@ TEST(BasicTest, BoardStateEquality) {
 	EXPECT_FALSE(state_2 == state_3);
 }
 
+TEST(BasicTest, BoardStateHash) {
+	DogGame game(true, false, false, false);
+	EXPECT_EQ(game.board_state.hash(), BoardState().hash());
+
+	game.load_board("P12P53|P16*P43F2F3||P15P56F3");
+	BoardState state = from_notation("P12P53|P16*P43F2F3||P15P56F3");
+	EXPECT_EQ(game.board_state.hash(), state.hash());
+	EXPECT_NE(game.board_state.hash(), from_notation("P12P53|P16P43F2F3||P15P56F3").hash());
+	EXPECT_NE(game.board_state.hash(), from_notation("P12P53||P16P43F2F3|P15P56F3").hash());
+
+	// Same position reached in different ways
+	EXPECT_TRUE(game.play_notation(0, "707"));
+	EXPECT_EQ(game.board_state.hash(), from_notation("P12P60|P16*P43F2F3||P15F3").hash());
+	EXPECT_EQ(game.board_state.hash(), game.board_state.compute_hash());
+
+	state = from_notation("P12P53|P16*P43F2F3||P15P56F3");
+	state.place_at_kennel(state.get_piece(BoardPosition(56)));
+	state.move_piece(state.get_piece(BoardPosition(53)), BoardPosition(60));
+	EXPECT_EQ(game.board_state.hash(), state.hash());
+
+	game.load_board("P1|P17||");
+	EXPECT_TRUE(game.play_notation(0, "J010"));
+	EXPECT_EQ(game.board_state.hash(), from_notation("P17|P1||").hash());
+	EXPECT_EQ(game.board_state.hash(), game.board_state.compute_hash());
+}
+
+TEST(BasicTest, OccupancyMasks) {
+	DogGame game(true, false, false, false);
+	game.load_board("P12P53|P16P43F2F3|P32*|P15P63F3");
+
+	EXPECT_EQ(game.board_state.get_path_mask(0), (UINT64_C(1) << 12) | (UINT64_C(1) << 53));
+	EXPECT_EQ(game.board_state.get_path_mask(1), (UINT64_C(1) << 16) | (UINT64_C(1) << 43));
+	EXPECT_EQ(game.board_state.get_path_mask(2), UINT64_C(1) << 32);
+	EXPECT_EQ(game.board_state.get_path_mask(3), (UINT64_C(1) << 15) | (UINT64_C(1) << 63));
+	EXPECT_EQ(game.board_state.get_blocking_mask(), UINT64_C(1) << 32);
+	EXPECT_EQ(game.board_state.get_finish_mask(1), 0b1100);
+	EXPECT_EQ(game.board_state.get_finish_mask(3), 0b1000);
+	EXPECT_EQ(game.board_state.get_kennel_mask(0), 0b1100);
+	EXPECT_EQ(game.board_state.get_kennel_mask(1), 0b0000);
+	EXPECT_EQ(game.board_state.get_kennel_mask(2), 0b1110);
+
+	// Seven that passes the pieces on 15 and 16
+	EXPECT_TRUE(game.play_notation(0, "717"));
+	EXPECT_EQ(game.board_state.get_path_mask(0), (UINT64_C(1) << 19) | (UINT64_C(1) << 53));
+	EXPECT_EQ(game.board_state.get_path_mask(1), UINT64_C(1) << 43);
+	EXPECT_EQ(game.board_state.get_path_mask(3), UINT64_C(1) << 63);
+	EXPECT_EQ(game.board_state.get_kennel_mask(1), 0b1000);
+	EXPECT_EQ(game.board_state.get_kennel_mask(3), 0b1100);
+	EXPECT_TRUE(game.board_state.check_state());
+}
+
+TEST(BasicTest, Features) {
+	DogGame game(true, false, false, false);
+	game.load_board("P12P53|P16P43F2F3|P32*|P15P63F3");
+
+	BoardFeatures features = game.board_state.features();
+	EXPECT_EQ(features.distance_to_finish, (std::array<int, PLAYER_COUNT>{ 63, 37, 64, 82 }));
+	EXPECT_EQ(features.progress, (std::array<int, PLAYER_COUNT>{ 65, 226, 0, 114 }));
+	EXPECT_EQ(features.kennel_count, (std::array<int, PLAYER_COUNT>{ 2, 0, 3, 1 }));
+	EXPECT_EQ(features.finish_count, (std::array<int, PLAYER_COUNT>{ 0, 2, 0, 1 }));
+	EXPECT_EQ(features.blocking_count, (std::array<int, PLAYER_COUNT>{ 0, 0, 1, 0 }));
+	EXPECT_EQ(features.threatened_count, (std::array<int, PLAYER_COUNT>{ 2, 2, 0, 2 }));
+	EXPECT_EQ(features, game.board_state.compute_features());
+
+	EXPECT_TRUE(game.play_notation(0, "717"));
+	EXPECT_EQ(game.board_state.features(), game.board_state.compute_features());
+
+	// Pieces can also be reached backwards with a four
+	game.load_board("P20|P16||");
+	EXPECT_EQ(game.board_state.features().threatened_count, (std::array<int, PLAYER_COUNT>{ 1, 1, 0, 0 }));
+
+	game.load_board("P20|P10||");
+	EXPECT_EQ(game.board_state.features().threatened_count, (std::array<int, PLAYER_COUNT>{ 1, 0, 0, 0 }));
+}
+
+TEST(BasicTest, BoardStateMemcpy) {
+	DogGame game(true, false, false, false);
+	game.load_board("P12P53|P16P43F2F3|P32*|P15P63F3");
+
+	BoardState copy;
+	std::memcpy(static_cast<void*>(&copy), &game.board_state, sizeof(BoardState));
+
+	EXPECT_TRUE(copy.check_state());
+	EXPECT_EQ(copy, game.board_state);
+	EXPECT_EQ(to_notation(copy), "P12P53|P16P43F2F3|P32*|P15P63F3");
+
+	// The copy does not share any state with the original
+	EXPECT_TRUE(copy.move_piece(copy.get_piece(12), 7, false, true, true));
+	EXPECT_TRUE(copy.check_state());
+	EXPECT_EQ(to_notation(copy), "P19P53|P43F2F3|P32*|P63F3");
+	EXPECT_EQ(to_notation(game.board_state), "P12P53|P16P43F2F3|P32*|P15P63F3");
+}
+
+TEST(BasicTest, MoveSpecifiersBytes) {
+	MoveSpecifiers specifiers = { MoveSpecifier(0, 1, 4, false), MoveSpecifier(2, 3, 3, true) };
+
+	// Removing an element leaves the same bytes as never adding it
+	MoveSpecifiers popped = specifiers;
+	popped.push_back(MoveSpecifier(1, 2, 1, true));
+	popped.pop_back();
+
+	EXPECT_EQ(popped, specifiers);
+	EXPECT_EQ(std::memcmp(&popped, &specifiers, sizeof(MoveSpecifiers)), 0);
+
+	popped.clear();
+	MoveSpecifiers empty;
+	EXPECT_EQ(std::memcmp(&popped, &empty, sizeof(MoveSpecifiers)), 0);
+
+	EXPECT_EQ(specifiers[1].get_piece_ref(), PieceRef(2, 3));
+	EXPECT_EQ(specifiers[1].count, 3);
+
+	// Vacated slots are not accessible
+	EXPECT_EQ(specifiers.at(1).count, 3);
+	EXPECT_THROW(specifiers.at(2), std::out_of_range);
+	EXPECT_THROW(popped.at(0), std::out_of_range);
+}
+
 TEST(PossibleAction, SevenSimple) {
 	DogGame game(true, false, false, false);
 	std::vector<ActionVar> actions;
@@ -1023,6 +1192,29 @@ TEST(PossibleAction, SevenSimple) {
 #endif
 }
 
+TEST(PossibleAction, SevenDistinctResults) {
+	DogGame game(true, false, false, false);
+
+	game.load_board("P0P8P16P24||P32P40P48P56|");
+	BoardState before = game.board_state;
+
+	// More results than the initial size of the result set in SevenGenerator.cpp
+	std::vector<ActionVar> actions = game.possible_actions_for_card(0, Seven, false);
+	EXPECT_EQ(actions.size(), 3360);
+
+	// Every action leads to a different position
+	std::set<std::string> results;
+
+	for (const ActionVar& action : actions) {
+		DogGame copy = game;
+		EXPECT_TRUE(copy.play(0, action));
+		results.insert(to_notation(copy.board_state));
+	}
+
+	EXPECT_EQ(results.size(), actions.size());
+	EXPECT_TRUE(game.board_state == before);
+}
+
 TEST(PossibleAction, SevenBlockades) {
 	DogGame game(true, false, false, false);
 	std::vector<ActionVar> actions;
@@ -1872,6 +2064,11 @@ TEST(FullGameTest, Discard) {
 
 	game.load_board("|||"); \
 
+	EXPECT_FALSE(game.has_legal_card_play(0));
+	EXPECT_TRUE(game.has_legal_card_play(1));
+	EXPECT_FALSE(game.has_legal_card_play(2));
+	EXPECT_TRUE(game.has_legal_card_play(3));
+
 	EXPECT_FALSE(game.play_notation(0, "DA"));
 	EXPECT_FALSE(game.play_notation(0, "D2"));
 	EXPECT_FALSE(game.play_notation(0, "D3"));
@@ -2693,19 +2890,105 @@ TEST(CanadianRuleOff, PossibleAction) {
 	TEST_POSSIBLE_ACTIONS(0, game, actions, -1, {});
 }
 
-TEST(UndoStack, General) {
+TEST(Journal, General) {
 	DogGame game(true, false, false, false);
-	game.board_state.undo_stack_activated = true;
 
 	// Trivial case
-	TEST_UNDO_STACK(game, "P0|||", 0);
+	TEST_JOURNAL(game, "P0|||", 0, "A'0");
 
 	// Restore blocking status
-	TEST_UNDO_STACK(game, "P0*|||", 0);
+	TEST_JOURNAL(game, "P0*|||", 0, "A'0");
 
 	// From finish
-	TEST_UNDO_STACK(game, "P0|||", 0);
+	TEST_JOURNAL(game, "P0|||", 0, "A'0");
 
 	// Restore piece from kennel
-	TEST_UNDO_STACK(game, "P0*|P1||", 0);
+	TEST_JOURNAL(game, "P0*|P1||", 0, "A'0");
+
+	// Start with a piece on the start
+	TEST_JOURNAL(game, "P1|P0||", 0, "A#");
+	TEST_JOURNAL(game, "P0P1|||", 0, "A#");
+
+	// Swap
+	TEST_JOURNAL(game, "P1|P17||", 0, "J010");
+
+	// Seven that sends several pieces back to their kennels
+	TEST_JOURNAL(game, "P5P21P37P53|P7P23P39P55||", 0, "702122231");
+}
+
+TEST(Journal, Nested) {
+	DogGame game(true, false, false, false);
+	game.load_board("P40|P17|P33|P49");
+
+	Journal journal;
+	std::size_t outer = game.board_state.begin_journal(journal);
+	EXPECT_TRUE(game.play_notation(0, "50"));
+
+	std::size_t inner = game.board_state.begin_journal();
+	EXPECT_TRUE(game.play_notation(1, "50"));
+	game.board_state.rollback_journal(inner);
+	EXPECT_EQ(to_notation(game.board_state), "P45|P17|P33|P49");
+
+	inner = game.board_state.begin_journal();
+	EXPECT_TRUE(game.play_notation(1, "50"));
+	game.board_state.commit_journal(inner);
+	EXPECT_EQ(to_notation(game.board_state), "P45|P22|P33|P49");
+
+	// Rolling back the outer journal also reverts the committed inner changes
+	game.board_state.rollback_journal(outer);
+	EXPECT_EQ(to_notation(game.board_state), "P40|P17|P33|P49");
+	EXPECT_TRUE(game.board_state.check_state());
+}
+
+TEST(Journal, Full) {
+	DogGame game(true, false, false, false);
+	game.load_board("P1|||");
+
+	Journal journal;
+	std::size_t mark = game.board_state.begin_journal(journal);
+
+	for (std::size_t i = 0; i < JOURNAL_CAPACITY; i++) {
+		EXPECT_TRUE(game.play_notation(0, "20"));
+	}
+
+	// The move is rejected before the board changes
+	EXPECT_THROW(game.play_notation(0, "20"), std::length_error);
+	EXPECT_EQ(to_notation(game.board_state), "P57|||");
+	EXPECT_TRUE(game.board_state.check_state());
+
+	game.board_state.rollback_journal(mark);
+	EXPECT_EQ(to_notation(game.board_state), "P1|||");
+	EXPECT_TRUE(game.board_state.check_state());
+}
+
+TEST(Undo, RandomGames) {
+	default_random_engine rng(0);
+
+	for (int i = 0; i < 20; i++) {
+		DogGame game(true);
+		std::vector<DogGame> history;
+		std::vector<UndoRecord> records;
+
+		// Long enough to cover several give phases and rounds
+		while (game.result() == -1 && records.size() < 400) {
+			std::vector<ActionVar> actions = game.get_possible_actions(game.player_turn);
+			std::uniform_int_distribution<int> uniform(0, actions.size() - 1);
+
+			history.push_back(game);
+			records.push_back(game.apply(actions.at(uniform(rng))));
+		}
+
+		while (!records.empty()) {
+			game.undo(records.back());
+			records.pop_back();
+
+			const DogGame& expected = history.back();
+			EXPECT_TRUE(game.board_state.check_state());
+			EXPECT_EQ(game.board_state, expected.board_state);
+			EXPECT_EQ(game.cards_state, expected.cards_state);
+			EXPECT_EQ(game.player_turn, expected.player_turn);
+			EXPECT_EQ(game.give_phase_done, expected.give_phase_done);
+			history.pop_back();
+		}
+	}
 }
@@ -0,0 +1,239 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <iterator>
+
+#include <libdog/libdog.hpp>
+
+
+using namespace libdog;
+
+#define DECK "95A454968X2X924KQ8K923KA62AJ66396XT89843J34T27397T5JJT73QX"
+
+static std::vector<Card> sorted(std::vector<Card> cards) {
+	std::sort(cards.begin(), cards.end());
+	return cards;
+}
+
+static std::vector<Card> get_unknown_cards(const CardsState& cards_state, int observer) {
+	std::vector<Card> result = cards_state.get_deck().get_cards();
+
+	for (int player = 0; player < PLAYER_COUNT; player++) {
+		if (player != observer) {
+			std::vector<Card> hand = cards_state.get_hand_cards(player);
+			result.insert(result.end(), hand.begin(), hand.end());
+		}
+	}
+
+	return sorted(result);
+}
+
+TEST(Ismcts, Determinization) {
+	DogGame game(true);
+	game.reset_with_deck("7XJ4AK7J4Q2KX73A9TJ7568Q" DECK);
+
+	// Player 0 gives a king to player 2
+	EXPECT_TRUE(game.play_notation(0, "GK"));
+	EXPECT_TRUE(game.play_notation(1, "G2"));
+	EXPECT_TRUE(game.play_notation(2, "G9"));
+	EXPECT_TRUE(game.play_notation(3, "G5"));
+	EXPECT_EQ(game.cards_state.get_given_card(0), King);
+
+	Rng rng(1);
+	bool changed = false;
+
+	for (int i = 0; i < 20; i++) {
+		CardsState sample = game.cards_state;
+		sample.sample_determinization(0, rng);
+
+		EXPECT_EQ(sample.get_hand_cards(0), game.cards_state.get_hand_cards(0));
+		EXPECT_EQ(get_unknown_cards(sample, 0), get_unknown_cards(game.cards_state, 0));
+
+		for (int player = 1; player < PLAYER_COUNT; player++) {
+			EXPECT_EQ(sample.get_hand_cards(player).size(), game.cards_state.get_hand_cards(player).size());
+		}
+
+		EXPECT_TRUE(sample.check_player_has_card(2, King));
+
+		changed |= !(sample == game.cards_state);
+	}
+
+	EXPECT_TRUE(changed);
+}
+
+TEST(Ismcts, DeterminizationGivePhase) {
+	CardsState cards_state(cards_from_str("KKKKKKAAAAAA222222333333" DECK));
+	cards_state.hand_out_cards(6);
+
+	// Player 0 does not know which card player 1 put into their give buffer, but knows their own
+	cards_state.give_card(0, King);
+	cards_state.give_card(1, Ace);
+
+	Rng rng(2);
+
+	for (int i = 0; i < 20; i++) {
+		CardsState sample = cards_state;
+		sample.sample_determinization(0, rng);
+
+		EXPECT_EQ(sample.get_hand_cards(0), cards_state.get_hand_cards(0));
+		EXPECT_EQ(sample.get_given_card(0), King);
+
+		// Apart from the hands and the deck, only the two give buffers hold cards. The one of player 0 is unchanged.
+		std::vector<Card> hidden;
+		std::vector<Card> all_cards = sorted(cards_from_str("KKKKKKAAAAAA222222333333" DECK));
+		std::vector<Card> visible = get_unknown_cards(sample, -1);
+		std::set_difference(all_cards.begin(), all_cards.end(), visible.begin(), visible.end(), std::back_inserter(hidden));
+		EXPECT_EQ(hidden.size(), 2);
+		EXPECT_THAT(hidden, testing::Contains(King));
+		EXPECT_EQ(sample.get_deck().size(), cards_state.get_deck().size());
+
+		for (int player = 1; player < PLAYER_COUNT; player++) {
+			EXPECT_EQ(sample.get_hand_cards(player).size(), cards_state.get_hand_cards(player).size());
+			EXPECT_EQ(sample.give_buffer_full(player), cards_state.give_buffer_full(player));
+		}
+	}
+}
+
+TEST(Ismcts, GivenCardForgotten) {
+	CardsState cards_state(cards_from_str("KKKKKKAAAAAA222222333333"));
+	cards_state.hand_out_cards(6);
+
+	cards_state.give_card(0, King);
+	cards_state.give_card(1, Ace);
+	cards_state.give_card(2, Two);
+	cards_state.give_card(3, Three);
+	cards_state.execute_give();
+	EXPECT_EQ(cards_state.get_given_card(0), King);
+
+	// Once player 2 plays a king, player 0 no longer knows whether they hold another one
+	cards_state.discard(2, King);
+	EXPECT_EQ(cards_state.get_given_card(0), None);
+}
+
+TEST(Ismcts, Search) {
+	DogGame game(true);
+	game.reset_with_deck(DECK);
+
+	IsmctsConfig config;
+	config.iterations = 50;
+	config.seed = 3;
+	config.rollout_max_moves = 50;
+
+	Ismcts ismcts(config);
+	IsmctsResult result = ismcts.search(game);
+
+	EXPECT_EQ(result.iterations, 50);
+
+	std::vector<ActionVar> possible = game.get_possible_actions(0);
+	EXPECT_EQ(result.actions.size(), possible.size());
+
+	uint64_t visits = 0;
+
+	for (const IsmctsActionStats& stats : result.actions) {
+		EXPECT_THAT(possible, testing::Contains(stats.action));
+		EXPECT_GT(stats.visits, 0);
+		EXPECT_GE(stats.mean_value, 0.0);
+		EXPECT_LE(stats.mean_value, 1.0);
+		visits += stats.visits;
+	}
+
+	EXPECT_EQ(visits, 50);
+
+	// Same seed, same search
+	Ismcts other(config);
+	IsmctsResult other_result = other.search(game);
+	EXPECT_EQ(other_result.best_action(), result.best_action());
+}
+
+TEST(Ismcts, FindsWinningMove) {
+	DogGame game(true, false, false, false);
+	game.reset_with_deck("32456832456832456832456" DECK);
+	game.load_board("P62F1F2F3|P20|F0F1F2F3|P40");
+	game.give_phase_done = true;
+
+	IsmctsConfig config;
+	config.iterations = 300;
+	config.rollout_max_moves = 100;
+
+	Ismcts ismcts(config);
+	IsmctsResult result = ismcts.search(game);
+
+	int player = game.switch_to_team_mate_if_done(0);
+	EXPECT_EQ(to_notation(player, result.best_action()), "33");
+}
+
+TEST(Ismcts, TreeParallel) {
+	DogGame game(true, false, false, false);
+	game.reset_with_deck("32456832456832456832456" DECK);
+	game.load_board("P62F1F2F3|P20|F0F1F2F3|P40");
+	game.give_phase_done = true;
+
+	IsmctsConfig config;
+	config.iterations = 400;
+	config.rollout_max_moves = 100;
+	config.thread_count = 4;
+
+	Ismcts ismcts(config);
+	IsmctsResult result = ismcts.search(game);
+
+	EXPECT_EQ(result.iterations, 400);
+	EXPECT_LE(result.node_count, 401);
+
+	// Every iteration passes through exactly one child of the root, duplicate expansions are merged
+	uint64_t visits = 0;
+
+	for (std::size_t i = 0; i < result.actions.size(); i++) {
+		visits += result.actions[i].visits;
+
+		for (std::size_t j = 0; j < i; j++) {
+			EXPECT_FALSE(result.actions[i].action == result.actions[j].action);
+		}
+	}
+
+	EXPECT_EQ(visits, 400);
+
+	int player = game.switch_to_team_mate_if_done(0);
+	EXPECT_EQ(to_notation(player, result.best_action()), "33");
+}
+
+TEST(Ismcts, PoolExhausted) {
+	DogGame game(true);
+	game.reset_with_deck(DECK);
+
+	IsmctsConfig config;
+	config.iterations = 100;
+	config.rollout_max_moves = 20;
+	config.max_nodes = 10;
+	config.thread_count = 2;
+
+	Ismcts ismcts(config);
+	IsmctsResult result = ismcts.search(game);
+
+	EXPECT_EQ(result.iterations, 100);
+	EXPECT_EQ(result.node_count, 10);
+
+	// The gives of the player are expanded long before the pool is exhausted
+	EXPECT_EQ(result.actions.size(), game.get_possible_actions(0).size());
+}
+
+TEST(Ismcts, PoolChunks) {
+	DogGame game(true);
+	game.reset_with_deck(DECK);
+
+	// The tree grows into the second chunk of the pool, which the workers allocate concurrently
+	IsmctsConfig config;
+	config.iterations = 2 * ISMCTS_NODE_CHUNK_SIZE;
+	config.rollout_max_moves = 1;
+	config.max_nodes = ISMCTS_NODE_CHUNK_SIZE + 5;
+	config.thread_count = 4;
+
+	Ismcts ismcts(config);
+
+	for (int i = 0; i < 2; i++) {
+		IsmctsResult result = ismcts.search(game);
+
+		EXPECT_EQ(result.iterations, config.iterations);
+		EXPECT_EQ(result.node_count, config.max_nodes);
+	}
+}
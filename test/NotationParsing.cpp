@@ -264,6 +264,7 @@ TEST(NotationParsing, Invalid) {
 	NOTATION_INVALID(0, "70'1-12-233'101");
 	NOTATION_INVALID(0, "701-0'1-0'1-0'1-4'1-0'1-0'1-");
 	NOTATION_INVALID(0, "701-0'1-0'1-0'1-0'1-0'1-0'2-");
+	NOTATION_INVALID(0, "70101010101010100");
 
 	// Whether or not these cases are valid is questionable
 //    NOTATION_INVALID(0, "70'1-0'1-0'1-0'1-0'1-0'1-0'1-");
@@ -169,4 +169,19 @@ TEST(NotationParsingBoard, Invalid) {
 	NOTATION_INVALID("F0F0|||");
 
 	NOTATION_INVALID("P0*P63P13F2|P16*F4F2F0|P32P33P34P31|P49*P48*F1");
+
+	NOTATION_INVALID("P*|||");
+	NOTATION_INVALID("P0**|||");
+	NOTATION_INVALID("P0|||*");
+	NOTATION_INVALID(std::string("P0|||\0", 6));
+}
+
+TEST(NotationParsingBoard, Whitespace) {
+	// Whitespace is ignored everywhere, even within a piece
+	optional<BoardState> board = try_parse_notation(" P0 * P1 6\t| P 17|\nF0 |");
+	ASSERT_TRUE(board.has_value());
+	EXPECT_EQ(to_notation(board.value()), "P0*P16|P17|F0|");
+
+	NOTATION_INVALID("P 123|||");
+	NOTATION_INVALID(" | | ");
 }
@@ -9,8 +9,9 @@ using namespace libdog;
 #define GAME_COUNT (1000)
 
 static std::vector<Card> generate_random_deck(int seed) {
-	CardStack single_deck(get_dog_card_set(), default_random_engine(seed));
-	single_deck.shuffle();
+	CardStack single_deck(get_dog_card_set());
+	Rng rng(seed);
+	single_deck.shuffle(rng);
 	CardStack deck;
 
 	int N = 100;
@@ -127,3 +128,25 @@ TEST(Performance, RandomGames) {
 //        std::cout << game << std::endl;
 	}
 }
+
+TEST(Performance, RandomPlayouts) {
+	Playout playout(uniform_random_policy, 0);
+
+	for (std::size_t i = 0; i < card_lists.size(); i++) {
+		DogGame game(true);
+		game.reset_with_deck(card_lists[i]);
+
+		playout.run(game);
+	}
+}
+
+TEST(Performance, Determinization) {
+	DogGame game(true);
+	game.reset_with_deck(card_lists[0]);
+	Rng rng(0);
+
+	// Sampling again from a sample is equivalent, this avoids copying the cards state
+	for (int i = 0; i < 1000; i++) {
+		game.cards_state.sample_determinization(i % PLAYER_COUNT, rng);
+	}
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <libdog/libdog.hpp>
+
+
+using namespace libdog;
+
+#define DECK_REST "95A454968X2X924KQ8K923KA62AJ66396XT89843J34T27397T5JJT73QX"
+
+#define EXPECT_PERFT(game_var_name, depth, expected_nodes, give, discard, start, move, move_multiple, swap) do { \
+	PerftResult result = perft(game_var_name, depth); \
+	EXPECT_EQ(result.nodes, expected_nodes); \
+	EXPECT_THAT(result.action_type_counts, testing::ElementsAre(give, discard, start, move, move_multiple, swap)); \
+} while(0)
+
+#define PLAY_GIVES(game_var_name, give_0, give_1, give_2, give_3) do { \
+	EXPECT_TRUE(game_var_name.play_notation(0, give_0)); \
+	EXPECT_TRUE(game_var_name.play_notation(1, give_1)); \
+	EXPECT_TRUE(game_var_name.play_notation(2, give_2)); \
+	EXPECT_TRUE(game_var_name.play_notation(3, give_3)); \
+} while(0)
+
+
+TEST(Perft, Initial) {
+	DogGame game(true);
+	game.reset_with_deck(DECK_REST);
+
+	EXPECT_PERFT(game, 0, 1, 0, 0, 0, 0, 0, 0);
+	EXPECT_PERFT(game, 1, 4, 4, 0, 0, 0, 0, 0);
+	EXPECT_PERFT(game, 4, 600, 600, 0, 0, 0, 0, 0);
+	EXPECT_PERFT(game, 5, 1000, 0, 450, 550, 0, 0, 0);
+}
+
+TEST(Perft, Midgame) {
+	DogGame game(true);
+	game.reset_with_deck("7XJ4AK7J4Q2KX73A9TJ7568Q" DECK_REST);
+	game.load_board("P5P12F1|P17P20|P32*P40|P49F0F3");
+
+	PLAY_GIVES(game, "GK", "G2", "G9", "G5");
+
+	EXPECT_PERFT(game, 1, 578, 0, 0, 3, 39, 520, 16);
+	EXPECT_PERFT(game, 2, 57955, 0, 0, 578, 5181, 47018, 5178);
+}
+
+TEST(Perft, SevensAndJokers) {
+	DogGame game(true);
+	game.reset_with_deck("77XX7J777JXX7X9T77XJJ7TT" DECK_REST);
+	game.load_board("P1P9F2|P40P20|P35P33|P55F3");
+
+	PLAY_GIVES(game, "GJ", "GJ", "G7", "GX");
+
+	EXPECT_PERFT(game, 1, 447, 0, 0, 2, 27, 408, 10);
+	EXPECT_PERFT(game, 2, 46660, 0, 0, 894, 11227, 30448, 4091);
+}
+
+TEST(Perft, Discard) {
+	DogGame game(true);
+	game.reset_with_deck("235689235689356892356892" DECK_REST);
+
+	PLAY_GIVES(game, "G2", "G3", "G5", "G6");
+
+	EXPECT_PERFT(game, 1, 5, 0, 5, 0, 0, 0, 0);
+	EXPECT_PERFT(game, 4, 625, 0, 625, 0, 0, 0, 0);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <libdog/libdog.hpp>
+
+
+using namespace libdog;
+
+TEST(Playout, UniformRandom) {
+	DogGame game(true);
+	Playout playout(uniform_random_policy, 42);
+
+	PlayoutResult result = playout.run(game);
+
+	EXPECT_THAT(result.winner, testing::AnyOf(0, 1));
+	EXPECT_GT(result.move_count, 0);
+
+	// The game the playout started from is left unchanged
+	EXPECT_EQ(game.board_state, DogGame(true).board_state);
+	EXPECT_EQ(game.player_turn, 0);
+
+	// Same as playing the game with the full checks
+	Rng rng(42);
+	int move_count = 0;
+
+	while (game.result() == -1) {
+		std::vector<ActionVar> actions = game.get_possible_actions(game.player_turn);
+		EXPECT_TRUE(game.play(game.player_turn, actions.at(rng.below(actions.size()))));
+		move_count++;
+	}
+
+	EXPECT_EQ(game.result(), result.winner);
+	EXPECT_EQ(move_count, result.move_count);
+}
+
+TEST(Playout, Deterministic) {
+	DogGame game(true);
+	game.load_board("P5P12F1|P17P20|P32*P40|P49F0F3");
+
+	for (PlayoutPolicy policy : { uniform_random_policy, greedy_policy }) {
+		Playout playout_a(policy, 7);
+		Playout playout_b(policy, 7);
+
+		for (int i = 0; i < 5; i++) {
+			PlayoutResult result_a = playout_a.run(game);
+			PlayoutResult result_b = playout_b.run(game);
+
+			EXPECT_THAT(result_a.winner, testing::AnyOf(0, 1));
+			EXPECT_EQ(result_a.winner, result_b.winner);
+			EXPECT_EQ(result_a.move_count, result_b.move_count);
+		}
+	}
+}
+
+TEST(Playout, MoveLimit) {
+	DogGame game(true);
+	Playout playout(uniform_random_policy, 0, 10);
+
+	PlayoutResult result = playout.run(game);
+
+	EXPECT_EQ(result.winner, -1);
+	EXPECT_EQ(result.move_count, 10);
+}
+
+TEST(Playout, Greedy) {
+	DogGame game(true, false, false, false);
+	game.load_board("P62F1F2F3||P30|");
+
+	ActionBuffer actions;
+	game.possible_actions_for_card(0, Three, false, actions);
+	game.possible_actions_for_card(0, Two, false, actions);
+	Rng rng;
+
+	// Entering the finish beats stopping right before it
+	std::size_t selection = greedy_policy(game, actions, rng);
+	EXPECT_EQ(to_notation(0, actions[selection]), "33");
+	EXPECT_EQ(to_notation(game.board_state), "P62F1F2F3||P30|");
+}
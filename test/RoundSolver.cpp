@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <libdog/libdog.hpp>
+
+
+using namespace libdog;
+
+#define DECK "95A454968X2X924KQ8K923KA62AJ66396XT89843J34T27397T5JJT73QX"
+
+static int evaluate_for_team(const DogGame& game, int team) {
+	int value = evaluate_progress(game.board_state);
+	return team == 0 ? value : -value;
+}
+
+// Plain minimax without pruning or table, with the same semantics as the solver
+static int minimax(DogGame& game, int depth) {
+	int team = game.player_turn % 2;
+	int best_value = -SOLVER_WIN_VALUE - 1;
+
+	for (const ActionVar& action : game.get_possible_actions(game.player_turn)) {
+		UndoRecord record = game.apply(action);
+
+		int winner = game.result();
+		bool round_over = !record.is_give && record.cards_state.has_value();
+		int value;
+
+		if (winner != -1) {
+			value = winner == team ? SOLVER_WIN_VALUE : -SOLVER_WIN_VALUE;
+		} else if (round_over || depth == 1) {
+			value = evaluate_for_team(game, team);
+		} else if (game.player_turn % 2 == team) {
+			value = minimax(game, depth - 1);
+		} else {
+			value = -minimax(game, depth - 1);
+		}
+
+		game.undo(record);
+
+		best_value = std::max(best_value, value);
+	}
+
+	return best_value;
+}
+
+// Plays random actions until the give phase of the second round is done and at most the given number of hand cards
+// are left
+static void play_into_round(DogGame& game, uint64_t seed, std::size_t max_hand_cards) {
+	game.reset_with_seed(seed);
+	Rng rng(seed);
+	int round_count = 0;
+
+	while (round_count == 0 || !game.give_phase_done || game.cards_state.get_hand_card_count() > max_hand_cards) {
+		std::vector<ActionVar> actions = game.get_possible_actions(game.player_turn);
+		UndoRecord record = game.apply(actions[rng.below(actions.size())]);
+
+		if (!record.is_give && record.cards_state.has_value()) {
+			round_count++;
+		}
+	}
+}
+
+TEST(RoundSolver, MatchesMinimax) {
+	for (uint64_t seed = 0; seed < 8; seed++) {
+		DogGame game(true);
+		play_into_round(game, seed, 8);
+		ASSERT_EQ(game.result(), -1);
+
+		int remaining = game.cards_state.get_hand_card_count();
+		int expected = minimax(game, remaining);
+
+		DogGame copy = game;
+		RoundSolver solver;
+		RoundSolverResult result = solver.solve(game);
+		EXPECT_EQ(game.board_state, copy.board_state);
+		EXPECT_EQ(game.cards_state, copy.cards_state);
+		EXPECT_EQ(game.player_turn, copy.player_turn);
+
+		EXPECT_EQ(result.value, expected);
+		EXPECT_GT(result.nodes, 0);
+
+		// Without the table, the solver has to reach the same value
+		RoundSolverConfig config;
+		config.table_size = 0;
+		RoundSolver solver_without_table(config);
+		EXPECT_EQ(solver_without_table.solve(game).value, expected);
+
+		// The line plays the round to its end and reaches the value
+		ASSERT_EQ(result.line.size(), remaining);
+		int team = game.player_turn % 2;
+
+		for (const ActionVar& action : result.line) {
+			EXPECT_THAT(game.get_possible_actions(game.player_turn), testing::Contains(action));
+			game.apply(action);
+		}
+
+		EXPECT_EQ(evaluate_for_team(game, team), expected);
+	}
+}
+
+TEST(RoundSolver, GivePhase) {
+	DogGame game(true);
+	game.reset_with_deck(DECK);
+
+	RoundSolverConfig config;
+	config.max_depth = 5;
+
+	RoundSolver solver(config);
+	RoundSolverResult result = solver.solve(game);
+
+	EXPECT_EQ(result.value, minimax(game, 5));
+	ASSERT_EQ(result.line.size(), 5);
+
+	for (int i = 0; i < PLAYER_COUNT; i++) {
+		EXPECT_TRUE(VAR_IS(result.line[i], Give));
+	}
+
+	EXPECT_FALSE(VAR_IS(result.line[4], Give));
+}
+
+TEST(RoundSolver, FindsWin) {
+	DogGame game(true, false, false, false);
+	game.reset_with_deck("32456832456832456832456" DECK);
+	game.load_board("P62F1F2F3|P20|F0F1F2F3|P40");
+	game.give_phase_done = true;
+
+	RoundSolver solver;
+	RoundSolverResult result = solver.solve(game);
+
+	EXPECT_EQ(result.value, SOLVER_WIN_VALUE);
+	ASSERT_EQ(result.line.size(), 1);
+
+	int player = game.switch_to_team_mate_if_done(0);
+	EXPECT_EQ(to_notation(player, result.line[0]), "33");
+}
+
+TEST(RoundSolver, GameOver) {
+	DogGame game(true, false, false, false);
+	game.reset_with_deck("32456832456832456832456" DECK);
+	game.load_board("F0F1F2F3|P20|F0F1F2F3|P40");
+	game.give_phase_done = true;
+
+	RoundSolver solver;
+	RoundSolverResult result = solver.solve(game);
+
+	EXPECT_EQ(result.value, SOLVER_WIN_VALUE);
+	EXPECT_TRUE(result.line.empty());
+
+	// Same position from the perspective of the losing team
+	game.player_turn = 1;
+	result = solver.solve(game);
+
+	EXPECT_EQ(result.value, -SOLVER_WIN_VALUE);
+	EXPECT_TRUE(result.line.empty());
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <libdog/libdog.hpp>
+
+
+using namespace libdog;
+
+TEST(Simulation, ResetWithSeed) {
+	DogGame game_a(true);
+	DogGame game_b(true);
+
+	game_a.reset_with_seed(1);
+	game_b.reset_with_seed(1);
+	EXPECT_EQ(game_a.cards_state, game_b.cards_state);
+
+	game_b.reset_with_seed(2);
+	EXPECT_FALSE(game_a.cards_state == game_b.cards_state);
+}
+
+TEST(Simulation, ReplayFromSeed) {
+	DogGame game_a(true);
+	game_a.reset_with_seed(7);
+	std::array<uint64_t, 4> initial_state = game_a.get_rng().get_state();
+
+	Rng rng(7);
+	std::vector<ActionVar> history;
+	bool reshuffled = false;
+
+	// Long enough for the discarded cards to be shuffled back into the deck
+	while (game_a.result() == -1 && history.size() < 400) {
+		std::size_t deck_size = game_a.cards_state.get_deck().size();
+
+		std::vector<ActionVar> actions = game_a.get_possible_actions(game_a.player_turn);
+		history.push_back(actions[rng.below(actions.size())]);
+		game_a.apply(history.back());
+
+		reshuffled |= game_a.cards_state.get_deck().size() > deck_size;
+	}
+
+	EXPECT_TRUE(reshuffled);
+	EXPECT_FALSE(game_a.get_rng().get_state() == initial_state);
+
+	DogGame game_b(true);
+	game_b.reset_with_seed(7);
+
+	for (const ActionVar& action : history) {
+		game_b.apply(action);
+	}
+
+	EXPECT_EQ(game_b.board_state, game_a.board_state);
+	EXPECT_EQ(game_b.cards_state, game_a.cards_state);
+
+	// A stored generator state continues the same sequence
+	Rng restored;
+	restored.set_state(game_a.get_rng().get_state());
+	EXPECT_EQ(restored(), game_a.get_rng()());
+}
+
+TEST(Simulation, IndependentOfThreadCount) {
+	SimulationConfig config;
+	config.game_count = 40;
+	config.seed = 123;
+	config.thread_count = 1;
+
+	SimulationStats single = simulate(config);
+
+	config.thread_count = 4;
+	SimulationStats multi = simulate(config);
+
+	EXPECT_EQ(single, multi);
+	EXPECT_EQ(single.game_count, 40);
+	EXPECT_EQ(single.wins[0] + single.wins[1], 40);
+	EXPECT_LE(single.min_game_length, single.max_game_length);
+	EXPECT_GT(single.get_mean_actions_per_move(), 1.0);
+
+	config.seed = 124;
+	EXPECT_FALSE(simulate(config) == single);
+}
+
+TEST(Simulation, MoveLimit) {
+	SimulationConfig config;
+	config.game_count = 10;
+	config.thread_count = 2;
+	config.max_moves = 20;
+
+	SimulationStats stats = simulate(config);
+
+	EXPECT_EQ(stats.game_count, 10);
+	EXPECT_EQ(stats.wins[0] + stats.wins[1], 0);
+	EXPECT_EQ(stats.move_count, 200);
+	EXPECT_EQ(stats.min_game_length, 20);
+	EXPECT_EQ(stats.max_game_length, 20);
+	EXPECT_DOUBLE_EQ(stats.get_win_rate(0), 0.0);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+
+#include <libdog/libdog.hpp>
+
+
+using namespace libdog;
+
+#define DECK "95A454968X2X924KQ8K923KA62AJ66396XT89843J34T27397T5JJT73QX"
+
+static TranspositionEntry make_entry(int32_t value, int8_t depth) {
+	TranspositionEntry result;
+	result.value = value;
+	result.depth = depth;
+	result.bound = BoundLower;
+	result.best_action = 3;
+	return result;
+}
+
+TEST(TranspositionTable, StoreProbe) {
+	TranspositionTable table(1 << 16);
+	EXPECT_EQ(table.get_capacity(), (1 << 16) / 64 * TT_BUCKET_SIZE);
+
+	TranspositionEntry entry;
+	EXPECT_FALSE(table.probe(42, entry));
+
+	table.store(42, make_entry(-7, 5));
+	EXPECT_TRUE(table.probe(42, entry));
+	EXPECT_EQ(entry, make_entry(-7, 5));
+
+	// Entries of the same key are overwritten
+	table.store(42, make_entry(9, 2));
+	EXPECT_TRUE(table.probe(42, entry));
+	EXPECT_EQ(entry, make_entry(9, 2));
+
+	table.clear();
+	EXPECT_FALSE(table.probe(42, entry));
+}
+
+TEST(TranspositionTable, Replacement) {
+	// A single bucket
+	TranspositionTable table(0);
+	EXPECT_EQ(table.get_capacity(), TT_BUCKET_SIZE);
+
+	for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+		table.store(i + 1, make_entry(i, 10 + i));
+	}
+
+	// The entry with the lowest depth is replaced
+	table.store(100, make_entry(100, 20));
+
+	TranspositionEntry entry;
+	EXPECT_FALSE(table.probe(1, entry));
+	EXPECT_TRUE(table.probe(100, entry));
+
+	for (int i = 1; i < TT_BUCKET_SIZE; i++) {
+		EXPECT_TRUE(table.probe(i + 1, entry));
+		EXPECT_EQ(entry.value, i);
+	}
+}
+
+TEST(TranspositionTable, Concurrent) {
+	TranspositionTable table(1 << 12);
+	std::vector<std::thread> threads;
+
+	// Every thread stores entries that can be derived from their key, so a probe must never return anything else
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([&table, t]() {
+			Rng rng(t);
+
+			for (int i = 0; i < 100000; i++) {
+				uint64_t key = rng.below(1000) * UINT64_C(0x9E3779B97F4A7C15);
+				TranspositionEntry entry;
+
+				if (table.probe(key, entry)) {
+					EXPECT_EQ(entry, make_entry(static_cast<int32_t>(key >> 32), static_cast<int8_t>(key % 50)));
+				}
+
+				table.store(key, make_entry(static_cast<int32_t>(key >> 32), static_cast<int8_t>(key % 50)));
+			}
+		});
+	}
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+TEST(TranspositionTable, GameHash) {
+	DogGame game_a(true);
+	DogGame game_b(true);
+
+	// Same hands, but the cards are in a different order
+	game_a.reset_with_deck("AK2345" "678TJQ" "A2K345" "678TJQ" DECK);
+	game_b.reset_with_deck("KA2345" "678TJQ" "A2K345" "678QJT" DECK);
+	EXPECT_EQ(game_a.hash(), game_b.hash());
+
+	// Same multiset of cards, but distributed differently among the players
+	game_b.reset_with_deck("678TJQ" "AK2345" "A2K345" "678TJQ" DECK);
+	EXPECT_NE(game_a.hash(), game_b.hash());
+
+	uint64_t initial = game_a.hash();
+	UndoRecord give = game_a.apply(Give(King));
+	EXPECT_NE(game_a.hash(), initial);
+
+	game_a.undo(give);
+	EXPECT_EQ(game_a.hash(), initial);
+
+	// The turn is part of the hash
+	game_a.player_turn = 1;
+	EXPECT_NE(game_a.hash(), initial);
+}
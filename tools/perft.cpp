@@ -0,0 +1,67 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+
+#include <libdog/libdog.hpp>
+
+
+using namespace libdog;
+
+static void print_usage(const char* program) {
+	std::cerr << "Usage: " << program << " <board notation> <deck> <depth>" << std::endl;
+	std::cerr << "Example: " << program << " \"P0*|P16*|P32*|P48*\" 95A454968X2X924KQ8K923KA62AJ66396XT8 5" << std::endl;
+}
+
+int main(int argc, const char *argv[]) {
+	if (argc != 4) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	std::string board_str = argv[1];
+	std::string deck_str = argv[2];
+	int depth;
+
+	try {
+		depth = std::stoi(argv[3]);
+	} catch (const std::logic_error&) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (depth < 0) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (!try_parse_notation(board_str).has_value()) {
+		std::cerr << "Invalid board notation: " << board_str << std::endl;
+		return 1;
+	}
+
+	DogGame game(true);
+	game.reset_with_deck(deck_str);
+	game.load_board(board_str);
+
+	auto start = std::chrono::steady_clock::now();
+	PerftResult result = perft(game, depth);
+	auto end = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	std::cout << "Depth: " << depth << std::endl;
+	std::cout << "Nodes: " << result.nodes << std::endl;
+
+	for (std::size_t i = 0; i < result.action_type_counts.size(); i++) {
+		std::cout << "  " << std::left << std::setw(14) << get_action_type_name(i) << result.action_type_counts[i] << std::endl;
+	}
+
+	std::cout << "Time: " << std::fixed << std::setprecision(3) << seconds << " s" << std::endl;
+
+	if (seconds > 0) {
+		std::cout << "Nodes per second: " << std::fixed << std::setprecision(0) << (result.nodes / seconds) << std::endl;
+	}
+
+	return 0;
+}
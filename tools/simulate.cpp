@@ -0,0 +1,75 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+
+#include <libdog/libdog.hpp>
+
+
+using namespace libdog;
+
+static void print_usage(const char* program) {
+	std::cerr << "Usage: " << program << " <games> [threads] [seed] [random|greedy]" << std::endl;
+	std::cerr << "Example: " << program << " 10000 8 42 random" << std::endl;
+}
+
+int main(int argc, const char *argv[]) {
+	if (argc < 2 || argc > 5) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	SimulationConfig config;
+
+	try {
+		config.game_count = std::stoull(argv[1]);
+
+		if (argc > 2) {
+			config.thread_count = std::stoul(argv[2]);
+		}
+
+		if (argc > 3) {
+			config.seed = std::stoull(argv[3]);
+		}
+	} catch (const std::logic_error&) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (argc > 4) {
+		std::string policy = argv[4];
+
+		if (policy == "random") {
+			config.policy = uniform_random_policy;
+		} else if (policy == "greedy") {
+			config.policy = greedy_policy;
+		} else {
+			print_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	SimulationStats stats = simulate(config);
+	auto end = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	std::cout << "Games: " << stats.game_count << std::endl;
+	std::cout << std::fixed << std::setprecision(4);
+	std::cout << "Win rate team 0: " << stats.get_win_rate(0) << std::endl;
+	std::cout << "Win rate team 1: " << stats.get_win_rate(1) << std::endl;
+	std::cout << std::setprecision(1);
+	std::cout << "Game length: " << stats.get_mean_game_length() << " moves (min " << stats.min_game_length << ", max " << stats.max_game_length << ")" << std::endl;
+	std::cout << std::setprecision(2);
+	std::cout << "Actions per move: " << stats.get_mean_actions_per_move() << std::endl;
+	std::cout << std::setprecision(3);
+	std::cout << "Time: " << seconds << " s" << std::endl;
+
+	if (seconds > 0) {
+		std::cout << std::setprecision(0);
+		std::cout << "Games per second: " << (stats.game_count / seconds) << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+
+#include <libdog/libdog.hpp>
+
+
+using namespace libdog;
+
+static void print_usage(const char* program) {
+	std::cerr << "Usage: " << program << " <output file> [region]" << std::endl;
+	std::cerr << "Example: " << program << " finish.dftb " << FINISH_TABLEBASE_DEFAULT_REGION << std::endl;
+}
+
+int main(int argc, const char *argv[]) {
+	if (argc < 2 || argc > 3) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	std::string path = argv[1];
+	int region = FINISH_TABLEBASE_DEFAULT_REGION;
+
+	try {
+		if (argc > 2) {
+			region = std::stoi(argv[2]);
+		}
+	} catch (const std::logic_error&) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (region < 0 || region > FINISH_TABLEBASE_MAX_REGION) {
+		std::cerr << "Region has to be between 0 and " << FINISH_TABLEBASE_MAX_REGION << std::endl;
+		return 1;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	FinishTablebase tablebase = FinishTablebase::generate(region);
+	auto end = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	std::size_t unsolvable = 0;
+	uint16_t max_value = 0;
+
+	for (uint32_t idx = 0; idx < tablebase.size(); idx++) {
+		uint16_t value = tablebase.get_value(idx);
+
+		if (value == FINISH_TABLEBASE_UNSOLVABLE) {
+			unsolvable++;
+		} else {
+			max_value = std::max(max_value, value);
+		}
+	}
+
+	std::cout << "Region: " << region << std::endl;
+	std::cout << "Positions: " << tablebase.size() << std::endl;
+	std::cout << "Unsolvable: " << unsolvable << std::endl;
+	std::cout << "Max expected turns: " << std::fixed << std::setprecision(2) << (static_cast<double>(max_value) / FINISH_TABLEBASE_SCALE) << std::endl;
+	std::cout << "Time: " << std::fixed << std::setprecision(3) << seconds << " s" << std::endl;
+
+	if (!tablebase.save(path)) {
+		std::cerr << "Could not write " << path << std::endl;
+		return 1;
+	}
+
+	return 0;
+}